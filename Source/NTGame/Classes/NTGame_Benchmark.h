@@ -0,0 +1,129 @@
+// Copyright (C) James Baxter 2017. All Rights Reserved.
+
+#pragma once
+
+#include "GameFramework/Actor.h"
+#include "NTGame_MovementTypes.h"
+#include "NTGame_Benchmark.generated.h"
+
+// Declarations
+class ANTGame_Pawn;
+class UNTGame_MovementComponent;
+
+/* Results gathered for a single pawn count */
+struct FNTGame_BenchmarkPhase
+{
+	FNTGame_BenchmarkPhase()
+		: NumPawns(0)
+		, NumSamples(0)
+		, TotalTickMS(0.f)
+		, MaxTickMS(0.f)
+		, NumConnections(0)
+		, TotalBytesIn(0.f)
+		, TotalBytesOut(0.f)
+		, NumConnectionSamples(0)
+		, StartGoodMoves(0)
+		, StartBadMoves(0)
+		, GoodMoves(0)
+		, BadMoves(0)
+		, StartBotBitsIn(0)
+		, StartBotBitsOut(0)
+		, BotBitsIn(0)
+		, BotBitsOut(0)
+		, Duration(0.f)
+	{}
+
+	int32 NumPawns;
+	int32 NumSamples;
+	float TotalTickMS;
+	float MaxTickMS;
+	int32 NumConnections;
+	float TotalBytesIn;
+	float TotalBytesOut;
+	int32 NumConnectionSamples;
+	uint32 StartGoodMoves;
+	uint32 StartBadMoves;
+	uint32 GoodMoves;
+	uint32 BadMoves;
+	uint64 StartBotBitsIn;
+	uint64 StartBotBitsOut;
+	uint64 BotBitsIn;
+	uint64 BotBitsOut;
+	float Duration;
+};
+
+/* Client side state of a single bot */
+struct FNTGame_BenchmarkBot
+{
+	FNTGame_BenchmarkBot()
+		: TimeStamp(0.f)
+		, AckedCorrectionId(0)
+		, ReceivedCorrectionId(0)
+		, CorrectionArrivalTime(0.f)
+	{}
+
+	// Client timestamp of the last move
+	float TimeStamp;
+	// Correction id echoed back in each move
+	uint8 AckedCorrectionId;
+	// Latest correction the server has sent, and when it 'arrives'
+	uint8 ReceivedCorrectionId;
+	float CorrectionArrivalTime;
+};
+
+/*
+* Server load benchmark. Spawns an increasing number of bot pawns driven by scripted input, and records server tick time,
+* per-connection bandwidth and correction rates for each step. Bots stand in for remote clients, and send their moves through the server's ServerMove path. Results are written as JSON to Saved/Benchmarks.
+* Run on a headless server with: -server -nullrhi -ExecCmds="NT.Benchmark <MaxPawns> <Step> <PhaseSeconds> [exit]"
+*/
+UCLASS(Transient, NotPlaceable)
+class NTGAME_API ANTGame_Benchmark : public AActor
+{
+	GENERATED_BODY()
+public:
+	ANTGame_Benchmark(const FObjectInitializer& OI);
+
+	virtual void Tick(float DeltaSeconds) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	void StartBenchmark(const int32 InMaxPawns, const int32 InPawnStep, const float InPhaseDuration, const bool bInExitWhenDone);
+
+	/* Scripted input pattern shared by benchmark bots and scenario runs */
+	static FRepPlayerInput GetScriptedInput(const float InTime);
+	static void DriveScriptedInput(UNTGame_MovementComponent* InMovement, const float InTime);
+
+protected:
+	UPROPERTY(Transient)
+	TArray<ANTGame_Pawn*> BotPawns;
+
+	TArray<FNTGame_BenchmarkBot> BotClients;
+
+	/* Simulated round trip before a bot acknowledges a correction */
+	float BotRoundTripTime;
+
+	int32 MaxPawns;
+	int32 PawnStep;
+	float PhaseDuration;
+	float WarmupDuration;
+	float PhaseTime;
+	float ScriptTime;
+	uint8 bExitWhenDone : 1;
+	uint8 bRunning : 1;
+	uint8 bSpawnFailed : 1;
+	int32 PrevBandwidthTelemetry;
+
+	TArray<FNTGame_BenchmarkPhase> Phases;
+
+	void BeginPhase(const int32 NumPawns);
+	void EndPhase();
+	void FinishBenchmark();
+
+	void SpawnBotPawns(const int32 NumPawns);
+	void DestroyBotPawns();
+	void DriveBotPawns(const float DeltaSeconds);
+
+	void SamplePhase(FNTGame_BenchmarkPhase& Phase);
+	void GetTotalMoveResults(uint32& OutGoodMoves, uint32& OutBadMoves) const;
+	void GetTotalBotBits(uint64& OutBitsIn, uint64& OutBitsOut) const;
+	void WriteResults() const;
+};
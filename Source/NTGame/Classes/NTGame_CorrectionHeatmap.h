@@ -0,0 +1,50 @@
+// Copyright (C) James Baxter 2017. All Rights Reserved.
+// Server-side spatial grid of client corrections, used to find areas and meshes that cause mispredictions.
+
+#pragma once
+
+/* Corrections accumulated in one grid cell */
+struct NTGAME_API FNTGame_HeatmapCell
+{
+	FNTGame_HeatmapCell()
+		: NumCorrections(0)
+		, NumInContact(0)
+		, TotalError(0.f)
+		, MaxError(0.f)
+	{}
+
+	uint32 NumCorrections;
+	uint32 NumInContact;		// Corrections where the pawn was touching something
+	float TotalError;
+	float MaxError;
+
+	TMap<FName, uint32> ContactCounts;	// Corrections per touched mesh
+
+	FName GetWorstContact() const;
+};
+
+/* Correction heatmap, shared by every movement component on the server */
+class NTGAME_API FNTGame_CorrectionHeatmap
+{
+public:
+	static FNTGame_CorrectionHeatmap& Get();
+	static bool IsEnabled();
+
+	void RecordCorrection(const FVector& InLocation, const float InError, const UPrimitiveComponent* InContact);
+	void Reset();
+
+	bool ExportCSV(const FString& InFilename) const;
+	void Draw(UWorld* InWorld, const float InDuration) const;
+
+	int32 GetNumCells() const { return Cells.Num(); }
+
+protected:
+	FNTGame_CorrectionHeatmap();
+
+	FIntVector GetCellKey(const FVector& InLocation) const;
+	FVector GetCellCentre(const FIntVector& InKey) const;
+
+	/* Cell size is fixed on the first correction after a reset, so CVar changes can't mix cell sizes */
+	float CellSize;
+	TMap<FIntVector, FNTGame_HeatmapCell> Cells;
+};
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "Blueprint/UserWidget.h"
+#include "NTGame_TelemetrySampler.h"
 #include "NTGame_DebugWidget.generated.h"
 
 class UTextBlock;
@@ -15,6 +16,7 @@ public:
 	UNTGame_DebugWidget(const FObjectInitializer& OI);
 
 	virtual void NativeTick(const FGeometry& MyGeometry, float InDeltaTime) override;
+	virtual void NativePaint(FPaintContext& InContext) const override;
 
 protected:
 	///////////////////
@@ -22,6 +24,34 @@ protected:
 	///////////////////
 
 	void UpdateDynamicData();
+	void UpdatePacketSimulationData();
+	void UpdateSparklines();
+
+	/* Only touches the text block when the displayed string changes, so Slate doesn't re-layout every sample */
+	void SetTextIfChanged(UTextBlock* InTextBlock, const FString& InString);
+
+	/////////////////////
+	///// Telemetry /////
+	/////////////////////
+
+	/* Samples per second. The overlay only updates when a sample is taken. */
+	UPROPERTY(EditDefaultsOnly, Category = "Telemetry", meta = (ClampMin = "1", ClampMax = "60"))
+	float SampleRate;
+
+	/* Sparklines are stacked from the origin, one per channel */
+	UPROPERTY(EditDefaultsOnly, Category = "Telemetry")
+	FVector2D SparklineOrigin;
+	UPROPERTY(EditDefaultsOnly, Category = "Telemetry")
+	FVector2D SparklineSize;
+	UPROPERTY(EditDefaultsOnly, Category = "Telemetry")
+	float SparklineSpacing;
+
+	FNTGame_TelemetrySampler Sampler;
+	TArray<FVector2D> SparklinePoints[(uint8)ENTGame_TelemetryChannel::MAX];
+	FString SparklineLabels[(uint8)ENTGame_TelemetryChannel::MAX];
+
+	TMap<const UTextBlock*, FString> DisplayedStrings;
+	int32 DisplayedPacketSettings[5];
 
 	////////////////////
 	///// Pointers /////
@@ -51,4 +81,16 @@ protected:
 	UTextBlock* PacketDupe;
 	UPROPERTY(meta = (BindWidget))
 	UTextBlock* PacketOrder;
+
+	// Telemetry, optional so older layouts still bind
+	UPROPERTY(meta = (BindWidget, OptionalWidget = true))
+	UTextBlock* RTTText;
+	UPROPERTY(meta = (BindWidget, OptionalWidget = true))
+	UTextBlock* ReplayText;
+	UPROPERTY(meta = (BindWidget, OptionalWidget = true))
+	UTextBlock* CorrectionText;
+	UPROPERTY(meta = (BindWidget, OptionalWidget = true))
+	UTextBlock* BandwidthText;
+	UPROPERTY(meta = (BindWidget, OptionalWidget = true))
+	UTextBlock* MovementTimeText;
 };
\ No newline at end of file
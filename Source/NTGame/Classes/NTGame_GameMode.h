@@ -15,10 +15,23 @@ class NTGAME_API ANTGame_GameMode : public AGameMode
 public:
 	ANTGame_GameMode(const FObjectInitializer& OI);
 
+	virtual void BeginPlay() override;
 	virtual APawn* SpawnDefaultPawnFor_Implementation(AController* NewPlayer, AActor* StartSpot) override;
 	virtual UClass* GetDefaultPawnClassForController_Implementation(AController* InController) override;
 
+	/* Unpossesses the pawn and keeps it for the next player that wants its class. Pawns that can't be pooled are destroyed. */
+	void ReleasePawn(APawn* InPawn);
+
 protected:
 	UPROPERTY(EditDefaultsOnly, Category = "Pawns")
 	TArray<TSubclassOf<ANTGame_Pawn>> AvailablePawns;
+
+	/* Pawns spawned up front for each available class, so switching pawns doesn't spawn actors. Zero disables pooling. */
+	UPROPERTY(EditDefaultsOnly, Category = "Pawns")
+	int32 PooledPawnsPerClass;
+
+	UPROPERTY(Transient)
+	TArray<ANTGame_Pawn*> PooledPawns;
+
+	ANTGame_Pawn* AcquirePooledPawn(UClass* InPawnClass, const FVector& InLocation, const FRotator& InRotation);
 };
\ No newline at end of file
@@ -0,0 +1,91 @@
+// Copyright (C) James Baxter 2017. All Rights Reserved.
+// Binary traces of client moves and server results, for offline determinism testing.
+
+#pragma once
+
+#include "NTGame_MovementTypes.h"
+
+/* Trace Record Types */
+enum class ENTGame_TraceRecord : uint8
+{
+	ClientMove,		// Move received from the client, applied before physics
+	ServerStep,		// Physics step on the server, and the resulting state
+};
+
+/* Single record in a trace. Only the fields relevant to the record type are serialized. */
+struct NTGAME_API FNTGame_MoveTraceRecord
+{
+	FNTGame_MoveTraceRecord()
+		: Type(ENTGame_TraceRecord::ClientMove)
+		, TimeStamp(0.f)
+		, DeltaTime(0.f)
+		, Input(FRepPlayerInput())
+		, MoveData(FRepPawnMoveData())
+	{}
+
+	ENTGame_TraceRecord Type;
+	float TimeStamp;
+	float DeltaTime;
+	FRepPlayerInput Input;
+	FRepPawnMoveData MoveData;		// Client End State for moves, Server End State for steps
+
+	friend FArchive& operator<<(FArchive& Ar, FNTGame_MoveTraceRecord& Record);
+};
+
+/* Trace file header */
+struct NTGAME_API FNTGame_MoveTraceHeader
+{
+	static const uint32 TraceMagic;
+	static const int32 TraceVersion;
+
+	FNTGame_MoveTraceHeader()
+		: Magic(TraceMagic)
+		, Version(TraceVersion)
+		, InitialState(FRepPawnMoveData())
+	{}
+
+	uint32 Magic;
+	int32 Version;
+	FString MapName;
+	FString PawnClassPath;
+	FRepPawnMoveData InitialState;
+
+	bool IsValid() const { return Magic == TraceMagic && Version == TraceVersion; }
+
+	friend FArchive& operator<<(FArchive& Ar, FNTGame_MoveTraceHeader& Header);
+};
+
+/* Streams records to disk while recording on the server */
+class NTGAME_API FNTGame_MoveTraceRecorder : protected FNoncopyable
+{
+public:
+	FNTGame_MoveTraceRecorder();
+	~FNTGame_MoveTraceRecorder();
+
+	bool Start(const FString& InFilename, FNTGame_MoveTraceHeader& InHeader);
+	void Stop();
+	bool IsRecording() const { return Writer != nullptr; }
+
+	void RecordClientMove(const float InTimeStamp, const float InAccelDelta, const FRepPlayerInput& InInput, const FRepPawnMoveData& InClientEndData);
+	void RecordServerStep(const float InDeltaTime, const FRepPawnMoveData& InServerEndData);
+
+	const FString& GetFilename() const { return Filename; }
+
+protected:
+	FArchive* Writer;
+	FString Filename;
+	int32 NumRecords;
+};
+
+/* Whole trace, loaded for replay */
+struct NTGAME_API FNTGame_MoveTrace
+{
+	FNTGame_MoveTraceHeader Header;
+	TArray<FNTGame_MoveTraceRecord> Records;
+
+	bool Load(const FString& InFilename);
+};
+
+/* Read / write raw (unquantized) movement data, so the trace holds exactly what each side simulated */
+NTGAME_API void SerializeTraceInput(FArchive& Ar, FRepPlayerInput& Input);
+NTGAME_API void SerializeTraceMoveData(FArchive& Ar, FRepPawnMoveData& MoveData);
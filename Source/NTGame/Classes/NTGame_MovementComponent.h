@@ -6,11 +6,21 @@
 #include "NTGame_MovementTypes.h"
 #include "NTGame_MovementComponent.generated.h"
 
+// Declarations
+class FNTGame_MoveTraceRecorder;
+
 UCLASS()
 class NTGAME_API UNTGame_MovementComponent : public UPawnMovementComponent, public INetworkPredictionInterface
 {
 	GENERATED_BODY()
 
+	// Offline trace replay drives movement directly
+	friend class UNTGame_TraceReplayCommandlet;
+	// Telemetry reads client prediction data
+	friend class FNTGame_TelemetrySampler;
+	// Benchmark bots send their moves straight into the server path
+	friend class ANTGame_Benchmark;
+
 	//////////////////////////
 	///// Initialization /////
 	//////////////////////////
@@ -24,6 +34,8 @@ public:
 	UPROPERTY() FPawnMovementPostPhysicsTickFunction PostPhysicsTickFunction;
 	virtual void PostPhysicsTickComponent(float DeltaTime, FPawnMovementPostPhysicsTickFunction& ThisTickFunction);
 	virtual void RegisterComponentTickFunctions(bool bRegister) override;
+	virtual void Activate(bool bReset = false) override;
+	virtual void Deactivate() override;
 
 	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction) override;
 		
@@ -43,6 +55,59 @@ public:
 
 protected:
 	void PerformMovement(const float DeltaTime, const FRepPlayerInput& InInput);
+
+	// Input part of Accel, and the ground found by the hover trace
+	FVector InputAccel;
+	float HoverGroundZ;
+	uint8 bHasHoverGround : 1;
+
+	FVector GetHoverAccel(const float InGroundZ, const float InHeight, const float InVelocityZ) const;
+
+	///////////////////////
+	///// Substepping /////
+	///////////////////////
+public:
+	/* Apply movement forces each physics substep instead of once per frame. Only used when substepping is enabled in the physics settings. */
+	UPROPERTY(EditDefaultsOnly, Category = "Substepping")
+	uint8 bApplyForcesPerSubstep : 1;
+
+	/* Number of substeps the physics scene will take for this delta, mirrors FPhysSubstepTask */
+	static int32 ComputeNumSubsteps(const float DeltaTime);
+
+protected:
+	bool IsApplyingForcesPerSubstep() const;
+	void SubstepPhysics(float SubstepDeltaTime, FBodyInstance* BodyInstance);
+	void ConsumePendingForces(const float SubstepDeltaTime, const bool bFlush, FBodyInstance* BodyInstance);
+	void ComputePendingDeltaV(const float SubstepDeltaTime, const bool bFlush, const float BodyHeight, const float BodyVelocityZ, FVector& OutLinearDeltaV, FVector& OutAngularDeltaV);
+	void FlushPendingForces();
+
+	FCalculateCustomPhysics OnCalculateCustomPhysics;
+	TArray<FNTGame_MoveForces> PendingForces;
+	int32 FrameSubsteps;
+	int32 SubstepIndex;
+	uint8 bCustomPhysicsRegistered : 1;
+
+	/////////////////////////////
+	///// Analytical Replay /////
+	/////////////////////////////
+public:
+	/* Replay moves that touched nothing with a rigid body integrator, instead of stepping the whole physics scene */
+	UPROPERTY(EditDefaultsOnly, Category = "Replay")
+	uint8 bEnableAnalyticalReplay : 1;
+	/* Moves that sweep within this distance of other geometry are replayed through the physics scene */
+	UPROPERTY(EditDefaultsOnly, Category = "Replay")
+	float AnalyticalReplaySweepMargin;
+
+	virtual void SetUpdatedComponent(USceneComponent* NewUpdatedComponent) override;
+
+protected:
+	UFUNCTION()
+	void OnUpdatedPrimitiveHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit);
+
+	bool ReplayMoveAnalytically(const FSavedPhysicsMovePtr& InMove);
+
+	// Set by PhysX contact notifies during the frame, saved with the client's move
+	uint8 bHadContactThisFrame : 1;
 	
 	/////////////////
 	///// Input /////
@@ -58,6 +123,10 @@ public:
 protected:
 	UPROPERTY(Transient) FRepPlayerInput RawControlInput;
 	UPROPERTY(Transient) FRepPlayerInput LastControlInput;
+	UPROPERTY(Transient) FRepPlayerInput LatestControlInput;
+
+	/* Inputs waiting to be applied when using input delay */
+	UPROPERTY(Transient) TArray<FRepPlayerInput> DelayedControlInputs;
 
 	virtual FRepPlayerInput ComputeAndConsumeInput();
 
@@ -80,6 +149,10 @@ public:
 	UPROPERTY(EditDefaultsOnly, Category = "Movement")
 	uint8 bEnableHoverSpring;
 
+	/* Input is applied this many ticks after it is sampled, on both client and server. Trades latency for fewer corrections. */
+	UPROPERTY(EditDefaultsOnly, Category = "Movement", meta = (ClampMin = "0", ClampMax = "8"))
+	uint8 InputDelayFrames;
+
 	UPROPERTY(EditDefaultsOnly, Category = "Hovering")
 	float HoverSpring_Tension;
 	UPROPERTY(EditDefaultsOnly, Category = "Hovering")
@@ -87,6 +160,68 @@ public:
 	UPROPERTY(EditDefaultsOnly, Category = "Hovering")
 	float HoverSpring_Damping;
 
+	/* When at rest with no input, the client only sends heartbeat moves to the server */
+	UPROPERTY(EditDefaultsOnly, Category = "Idle")
+	uint8 bEnableIdleMode : 1;
+	UPROPERTY(EditDefaultsOnly, Category = "Idle")
+	float IdleVelocityThreshold;
+	UPROPERTY(EditDefaultsOnly, Category = "Idle")
+	float IdleHeartbeatInterval;
+
+	bool IsAtRest(const FRepPlayerInput& InInput, const FRepPawnMoveData& InMoveData) const;
+
+	/* When client moves are missing, the server keeps simulating with the last received input for a short time */
+	UPROPERTY(EditDefaultsOnly, Category = "Extrapolation")
+	uint8 bExtrapolateMissingInput : 1;
+	UPROPERTY(EditDefaultsOnly, Category = "Extrapolation")
+	float MaxInputExtrapolationTime;
+	/* Exponential decay rate of extrapolated input per second. Zero holds the input constant. */
+	UPROPERTY(EditDefaultsOnly, Category = "Extrapolation")
+	float InputExtrapolationDecay;
+
+	/* Server tells the client how far ahead it's moves arrive, client speeds up / slows down it's clock to stay at the target lead */
+	UPROPERTY(EditDefaultsOnly, Category = "Time Dilation")
+	uint8 bEnableTimeDilation : 1;
+	UPROPERTY(EditDefaultsOnly, Category = "Time Dilation")
+	float TimeDilationUpdateInterval;
+	/* Target lead is this many times the measured arrival jitter */
+	UPROPERTY(EditDefaultsOnly, Category = "Time Dilation")
+	float TimeDilationJitterMultiplier;
+	/* Dilation per second of lead error */
+	UPROPERTY(EditDefaultsOnly, Category = "Time Dilation")
+	float TimeDilationGain;
+	UPROPERTY(EditDefaultsOnly, Category = "Time Dilation")
+	float MaxTimeDilation;
+
+	/* Server corrects the client when any part of its end state is outside these tolerances */
+	UPROPERTY(EditDefaultsOnly, Category = "Error Tolerance")
+	float LocationErrorTolerance;
+	UPROPERTY(EditDefaultsOnly, Category = "Error Tolerance")
+	float RotationErrorTolerance;				// Degrees
+	UPROPERTY(EditDefaultsOnly, Category = "Error Tolerance")
+	float LinearVelocityErrorTolerance;
+	UPROPERTY(EditDefaultsOnly, Category = "Error Tolerance")
+	float AngularVelocityErrorTolerance;		// Degrees per second
+	/* Tolerances grow by this fraction per unit of speed, e.g 0.001 doubles them at 1000 units/s. Zero keeps them fixed. */
+	UPROPERTY(EditDefaultsOnly, Category = "Error Tolerance")
+	float ErrorToleranceSpeedScale;
+	/* Seconds of out-of-tolerance error allowed to build up before correcting. Zero corrects every bad move. */
+	UPROPERTY(EditDefaultsOnly, Category = "Error Tolerance")
+	float ErrorBudget;
+	/* Errors this many times over tolerance are corrected straight away, whatever is left of the budget */
+	UPROPERTY(EditDefaultsOnly, Category = "Error Tolerance")
+	float MaxErrorScale;
+
+	/* Server keeps one correction in flight per client, and holds back new ones until the client has applied it */
+	UPROPERTY(EditDefaultsOnly, Category = "Corrections")
+	uint8 bLimitCorrections : 1;
+	/* Time on top of the client's ping to wait for a correction to be applied, before assuming it was lost */
+	UPROPERTY(EditDefaultsOnly, Category = "Corrections")
+	float CorrectionAckTimeout;
+	/* Send corrections as a delta from the state the client reported, when the error is small enough */
+	UPROPERTY(EditDefaultsOnly, Category = "Corrections")
+	uint8 bDeltaEncodeCorrections : 1;
+
 	////////////////////////////////////////
 	///// Network Prediction Interface /////
 	////////////////////////////////////////
@@ -101,6 +236,9 @@ public:
 	virtual void ResetPredictionData_Client() override;
 	virtual void ResetPredictionData_Server() override;
 
+	/* Drops prediction, input and pending force state, so a pooled pawn comes back as if newly spawned */
+	void ResetMovementState();
+
 	virtual bool HasPredictionData_Client() const { return ClientPredictionData != nullptr; }
 	virtual bool HasPredictionData_Server() const { return ServerPredictionData != nullptr; }
 
@@ -115,23 +253,58 @@ protected:
 	///// Replication /////
 	///////////////////////
 public:
+	/* Body state is read and written on the PhysX actor in one lock. Writes leave the component to be synced once, with SyncComponentToBody. */
+	FRepPawnMoveData GetCurrentMoveData() const;
+	void SetCurrentMoveData(const FRepPawnMoveData& InMoveData);
+	void SyncComponentToBody();
+
+	/* Client and server snap the body to the network quantization grid at the end of every move, so both start the next move from identical states */
+	UPROPERTY(EditDefaultsOnly, Category = "Replication")
+	uint8 bQuantizeMoveState : 1;
+
+	void QuantizeMoveState(FRepPawnMoveData& InOutMoveData);
+
+	/* Corrections carry every body of a multi-body pawn, not just the root, so constraints come out of a replay in the right state */
+	UPROPERTY(EditDefaultsOnly, Category = "Replication")
+	uint8 bReplicateAllBodies : 1;
+
+	/* Non-root bodies relative to the root. Empty unless replicating all bodies of a multi-body primitive. Set after the root has been placed. */
+	void GetBodySnapshot(FRepPawnBodySnapshot& OutSnapshot) const;
+	void SetBodySnapshot(const FRepPawnBodySnapshot& InSnapshot);
 
 protected:
 	UFUNCTION(Server, Unreliable, WithValidation)
-	void ServerMove(const float MoveTimeStamp, const FRepPlayerInput ClientInput, const FRepPawnMoveData& EndMoveData);
-	void ServerMove_Implementation(const float MoveTimeStamp, const FRepPlayerInput ClientInput, const FRepPawnMoveData& EndMoveData);	
-	bool ServerMove_Validate(const float MoveTimeStamp, const FRepPlayerInput ClientInput, const FRepPawnMoveData& EndMoveData) { return true; }
+	void ServerMove(const float MoveTimeStamp, const FRepPlayerInput ClientInput, const FRepPawnMoveData& EndMoveData, const uint8 ClientCorrectionId);
+	void ServerMove_Implementation(const float MoveTimeStamp, const FRepPlayerInput ClientInput, const FRepPawnMoveData& EndMoveData, const uint8 ClientCorrectionId);
+	bool ServerMove_Validate(const float MoveTimeStamp, const FRepPlayerInput ClientInput, const FRepPawnMoveData& EndMoveData, const uint8 ClientCorrectionId) { return true; }
+
+	/* Only sent with input delay, carries the input the client has just read but won't apply yet */
+	UFUNCTION(Server, Unreliable, WithValidation)
+	void ServerMoveWithLatestInput(const float MoveTimeStamp, const FRepPlayerInput ClientInput, const FRepPlayerInput ClientLatestInput, const FRepPawnMoveData& EndMoveData, const uint8 ClientCorrectionId);
+	void ServerMoveWithLatestInput_Implementation(const float MoveTimeStamp, const FRepPlayerInput ClientInput, const FRepPlayerInput ClientLatestInput, const FRepPawnMoveData& EndMoveData, const uint8 ClientCorrectionId);
+	bool ServerMoveWithLatestInput_Validate(const float MoveTimeStamp, const FRepPlayerInput ClientInput, const FRepPlayerInput ClientLatestInput, const FRepPawnMoveData& EndMoveData, const uint8 ClientCorrectionId) { return true; }
+
+	void ServerProcessMove(const float MoveTimeStamp, const FRepPlayerInput& ClientInput, const FRepPlayerInput* ClientLatestInput, const FRepPawnMoveData& EndMoveData, const uint8 ClientCorrectionId);
 
 	UFUNCTION(Client, Unreliable)
-	void ClientAckBadMove(const float MoveTimeStamp, const FRepPawnMoveData& ServerEndMoveData);
-	void ClientAckBadMove_Implementation(const float MoveTimeStamp, const FRepPawnMoveData& ServerEndMoveData);
+	void ClientAckBadMove(const float MoveTimeStamp, const FRepPawnMoveCorrection& ServerCorrection, const FRepPawnBodySnapshot& ServerEndBodies, const uint8 CorrectionId);
+	void ClientAckBadMove_Implementation(const float MoveTimeStamp, const FRepPawnMoveCorrection& ServerCorrection, const FRepPawnBodySnapshot& ServerEndBodies, const uint8 CorrectionId);
 
 	UFUNCTION(Client, Unreliable)
 	void ClientAckGoodMove(const float MoveTimestamp);
 	void ClientAckGoodMove_Implementation(const float MoveTimestamp);
+
+	UFUNCTION(Client, Unreliable)
+	void ClientUpdateMoveLead(const int8 LeadErrorMS);
+	void ClientUpdateMoveLead_Implementation(const int8 LeadErrorMS);
 		
 	void ServerMove_PostSim();
-	bool ServerCheckClientError(const FSavedPhysicsMovePtr& CurrentlyProcessingClientMove) const;
+	/* Pawns with no owning connection (e.g. benchmark bots) have nobody to send client RPC's to */
+	bool ServerHasClientConnection() const;
+	void ServerReconcileExtrapolatedInput(FNetworkPredictionData_Server_Physics& ServerData);
+	bool ServerCheckClientError(const float ErrorScale, const float AccumulatedError) const;
+	float ServerGetClientErrorScale(const FRepPawnMoveData& ClientData, const FRepPawnMoveData& ServerData) const;
+	bool ServerIsCorrectionInFlight(const FNetworkPredictionData_Server_Physics& ServerData) const;
 
 	bool ClientConditionalReplayBadMoves();
 	void ReplayMove(const FSavedPhysicsMovePtr& InMove);
@@ -139,14 +312,34 @@ protected:
 	void ClientPrepareMove_PreSim();
 	void ClientPrepareMove_PostSim(const float DeltaTime);	
 
+	void SimulatePhysicsScene(const float DeltaTime, const int32 NumSubsteps = 1);
+
+	// Body has been moved without updating the component
+	uint8 bComponentNeedsSync : 1;
+
+
 	/////////////////////
 	///// Debugging /////
 	/////////////////////
 public:
 	UPROPERTY(EditDefaultsOnly, Category = "Debug") uint8 bDrawDebug : 1;
 
+	FORCEINLINE const FNTGame_BandwidthStats& GetBandwidthStats() const { return BandwidthStats; }
+	FORCEINLINE void ResetBandwidthStats() { BandwidthStats.Reset(GetWorld()->GetTimeSeconds()); }
+	FORCEINLINE uint64 GetMovementCycles() const { return MovementCycles; }
+
+	void StartMoveTrace(const FString& InFilename);
+	void StopMoveTrace();
+
 protected:
 	void Client_DrawMoveBuffer(const float DeltaTime, const FColor& InColour);
+	void Server_RecordCorrection(const FRepPawnMoveData& InClientData, const FRepPawnMoveData& InServerData) const;
+
+	FNTGame_BandwidthStats BandwidthStats;
+	TSharedPtr<FNTGame_MoveTraceRecorder> TraceRecorder;
+
+	// Total cycles spent in both movement ticks
+	uint64 MovementCycles;
 
 	//////////////////////////////////
 	///// TimeStamp Verification /////
@@ -157,6 +350,7 @@ protected:
 	bool VerifyClientTimeStamp(const float TimeStamp, FNetworkPredictionData_Server_Physics& ServerData);
 	bool IsClientTimeStampValid(const float TimeStamp, FNetworkPredictionData_Server_Physics& ServerData, bool& bTimeStampResetDetected) const;
 	void ProcessClientTimeStampForTimeDiscrepancy(float ClientTimeStamp, FNetworkPredictionData_Server_Physics& ServerData);
+	void ProcessClientTimeStampForTimeDilation(float ClientTimeStamp, FNetworkPredictionData_Server_Physics& ServerData);
 
 	void OnClientTimeStampResetDetected();
 	void OnTimeDiscrepancyDetected(float CurrentTimeDiscrepancy, float LifetimeRawTimeDiscrepancy, float LifeTime, const float CurrentMoveError);
@@ -41,6 +41,8 @@ struct FRepPlayerInput
 	/* Binary Serialization */
 	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
 	{
+		SCOPE_CYCLE_COUNTER(STAT_NTMovement_NetSerializeInput);
+
 		// Start As True
 		// Write Packing
 		uint8 ByteForward = CompressByte(ForwardAxis);
@@ -49,21 +51,22 @@ struct FRepPlayerInput
 		uint8 BytePitch = CompressByte(PitchAxis);
 		uint8 ByteControl = ControlFlags;
 
-		uint8 B = (ByteForward != 0);
+		// Axes only send their byte when not at rest, zero axes cost a single bit
+		uint8 B = (ByteForward != ZeroAxisByte);
 		Ar.SerializeBits(&B, 1);
-		if (B) Ar << ByteForward; else ByteForward = 0;
+		if (B) Ar << ByteForward; else ByteForward = ZeroAxisByte;
 
-		B = (ByteStrafe != 0);
+		B = (ByteStrafe != ZeroAxisByte);
 		Ar.SerializeBits(&B, 1);
-		if (B) Ar << ByteStrafe; else ByteStrafe = 0;
+		if (B) Ar << ByteStrafe; else ByteStrafe = ZeroAxisByte;
 
-		B = (ByteSteer != 0);
+		B = (ByteSteer != ZeroAxisByte);
 		Ar.SerializeBits(&B, 1);
-		if (B) Ar << ByteSteer; else ByteSteer = 0;
+		if (B) Ar << ByteSteer; else ByteSteer = ZeroAxisByte;
 
-		B = (BytePitch != 0);
+		B = (BytePitch != ZeroAxisByte);
 		Ar.SerializeBits(&B, 1);
-		if (B) Ar << BytePitch; else BytePitch = 0;
+		if (B) Ar << BytePitch; else BytePitch = ZeroAxisByte;
 
 		B = (ByteControl != 0);
 		Ar.SerializeBits(&B, 1);
@@ -74,7 +77,7 @@ struct FRepPlayerInput
 			ForwardAxis = DecompressByte(ByteForward);
 			StrafeAxis = DecompressByte(ByteStrafe);
 			SteerAxis = DecompressByte(ByteSteer);
-			SteerAxis = DecompressByte(ByteSteer);
+			PitchAxis = DecompressByte(BytePitch);
 			ControlFlags = ByteControl;
 		}
 
@@ -82,6 +85,7 @@ struct FRepPlayerInput
 	}
 
 	/* Compress / Decompress Axes to Bytes */
+	static const uint8 ZeroAxisByte = 127;
 	FORCEINLINE uint8 CompressByte(const float X) const
 	{
 		// Need an ODD number of combinations so that we can quantize perfectly to zero (so we use 254 instead of 256)
@@ -166,16 +170,33 @@ struct FRepPawnMoveData
 
 	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
 	{
-		bOutSuccess = true;
+		SCOPE_CYCLE_COUNTER(STAT_NTMovement_NetSerializeMoveData);
 
-		// 2 DP of precision
-		bOutSuccess &= SerializePackedVector<100, 30>(Location, Ar);
-		bOutSuccess &= Rotation.Serialize(Ar);									// FQuat also has a NetSerialize Function.. absolutely no idea where it's defined though.
-		bOutSuccess &= SerializePackedVector<100, 30>(LinearVelocity, Ar);
-		bOutSuccess &= SerializePackedVector<100, 30>(AngularVelocity, Ar);
+		bOutSuccess = true;
+		bOutSuccess &= SerializeLocation(Ar);
+		bOutSuccess &= SerializeRotation(Ar);
+		bOutSuccess &= SerializeLinearVelocity(Ar);
+		bOutSuccess &= SerializeAngularVelocity(Ar);
 
 		return true;
 	}
+
+	/* Per-field serializers, also used by bandwidth telemetry to measure each field. 2 DP of precision. */
+	FORCEINLINE bool SerializeLocation(FArchive& Ar) { return SerializePackedVector<100, 30>(Location, Ar); }
+	FORCEINLINE bool SerializeRotation(FArchive& Ar) { return Rotation.Serialize(Ar); }				// FQuat also has a NetSerialize Function.. absolutely no idea where it's defined though.
+	FORCEINLINE bool SerializeLinearVelocity(FArchive& Ar) { return SerializePackedVector<100, 30>(LinearVelocity, Ar); }
+	FORCEINLINE bool SerializeAngularVelocity(FArchive& Ar) { return SerializePackedVector<100, 30>(AngularVelocity, Ar); }
+
+	/* Snaps to exactly what the other end will receive, by round-tripping through NetSerialize */
+	void Quantize()
+	{
+		bool bSuccess = true;
+		FBitWriter Writer(512, true);
+		NetSerialize(Writer, nullptr, bSuccess);
+
+		FBitReader Reader(Writer.GetData(), Writer.GetNumBits());
+		NetSerialize(Reader, nullptr, bSuccess);
+	}
 };
 
 /* Enables Net Serialization of FRepPawnMoveData */
@@ -188,6 +209,206 @@ struct TStructOpsTypeTraits<FRepPawnMoveData> : public TStructOpsTypeTraitsBase
 	};
 };
 
+/*
+* Server's end state for a corrected move. Small errors are sent as a delta from the state the client reported for the move,
+* which the client still has in its saved move. Large errors fall back to the absolute state.
+*/
+USTRUCT()
+struct FRepPawnMoveCorrection
+{
+	GENERATED_USTRUCT_BODY()
+
+	/* Largest delta per component that can be sent, anything bigger is sent absolute */
+	static const float MaxDelta;
+	/* Smallest rotation delta (degrees) that survives quantization. Smaller errors are sent absolute, or the client would keep them. */
+	static const float RotationQuantum;
+
+	UPROPERTY() FRepPawnMoveData MoveData;		// Absolute, or (Server - Client) when bIsDelta
+	UPROPERTY() bool bIsDelta;
+
+	FRepPawnMoveCorrection()
+		: MoveData(FRepPawnMoveData())
+		, bIsDelta(false)
+	{}
+
+	explicit FRepPawnMoveCorrection(const FRepPawnMoveData& InAbsoluteData)
+		: MoveData(InAbsoluteData)
+		, bIsDelta(false)
+	{}
+
+	/* Encodes the server state, as a delta from the client's state where it fits */
+	static FRepPawnMoveCorrection Make(const FRepPawnMoveData& InServerData, const FRepPawnMoveData& InClientData)
+	{
+		FRepPawnMoveCorrection Correction = FRepPawnMoveCorrection(InServerData);
+
+		FRepPawnMoveData Delta = FRepPawnMoveData(
+			InServerData.Location - InClientData.Location,
+			(InServerData.Rotation * InClientData.Rotation.Inverse()).GetNormalized(),
+			InServerData.LinearVelocity - InClientData.LinearVelocity,
+			InServerData.AngularVelocity - InClientData.AngularVelocity);
+
+		// The absolute quat is lossless, so only send rotation as a delta when it comes through intact enough
+		const float RotationDelta = QuatToRotationVector(Delta.Rotation).GetAbsMax();
+		const bool bRotationFits = RotationDelta < MaxDelta && (Delta.Rotation.Equals(FQuat::Identity, 0.f) || RotationDelta >= RotationQuantum);
+
+		if (bRotationFits && Delta.Location.GetAbsMax() < MaxDelta && Delta.LinearVelocity.GetAbsMax() < MaxDelta && Delta.AngularVelocity.GetAbsMax() < MaxDelta)
+		{
+			Correction.MoveData = Delta;
+			Correction.bIsDelta = true;
+		}
+
+		return Correction;
+	}
+
+	/* Server state, given the client's state for the same move */
+	FRepPawnMoveData Resolve(const FRepPawnMoveData& InClientData) const
+	{
+		if (!bIsDelta) { return MoveData; }
+
+		// The server's reference went over the wire, so match it exactly
+		FRepPawnMoveData Reference = InClientData;
+		Reference.Quantize();
+
+		return FRepPawnMoveData(
+			Reference.Location + MoveData.Location,
+			(MoveData.Rotation * Reference.Rotation).GetNormalized(),
+			Reference.LinearVelocity + MoveData.LinearVelocity,
+			Reference.AngularVelocity + MoveData.AngularVelocity);
+	}
+
+	/* Rotation deltas are sent as axis * angle in degrees */
+	static FVector QuatToRotationVector(const FQuat& InQuat)
+	{
+		FVector Axis = FVector::ZeroVector;
+		float Angle = 0.f;
+		InQuat.ToAxisAndAngle(Axis, Angle);
+
+		// Take the short way round
+		if (Angle > PI) { Angle -= 2.f * PI; }
+		return Axis * FMath::RadiansToDegrees(Angle);
+	}
+
+	static FQuat RotationVectorToQuat(const FVector& InVector)
+	{
+		const float AngleDeg = InVector.Size();
+		return AngleDeg > KINDA_SMALL_NUMBER ? FQuat(InVector / AngleDeg, FMath::DegreesToRadians(AngleDeg)) : FQuat::Identity;
+	}
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+	{
+		uint8 bDelta = bIsDelta;
+		Ar.SerializeBits(&bDelta, 1);
+		bIsDelta = bDelta != 0;
+
+		if (!bIsDelta)
+		{
+			return MoveData.NetSerialize(Ar, Map, bOutSuccess);
+		}
+
+		SCOPE_CYCLE_COUNTER(STAT_NTMovement_NetSerializeMoveData);
+		bOutSuccess = true;
+		bOutSuccess &= SerializeDeltaLocation(Ar);
+		bOutSuccess &= SerializeDeltaRotation(Ar);
+		bOutSuccess &= SerializeDeltaLinearVelocity(Ar);
+		bOutSuccess &= SerializeDeltaAngularVelocity(Ar);
+
+		return true;
+	}
+
+	/*
+	* Per-field serializers for the delta branch. Location and velocities keep the absolute 2 DP, in 16 bits per component up to MaxDelta.
+	* Rotation is quantized to RotationQuantum degrees, where the absolute quat is lossless.
+	*/
+	FORCEINLINE bool SerializeDeltaLocation(FArchive& Ar) { return SerializePackedVector<100, 16>(MoveData.Location, Ar); }
+	FORCEINLINE bool SerializeDeltaLinearVelocity(FArchive& Ar) { return SerializePackedVector<100, 16>(MoveData.LinearVelocity, Ar); }
+	FORCEINLINE bool SerializeDeltaAngularVelocity(FArchive& Ar) { return SerializePackedVector<100, 16>(MoveData.AngularVelocity, Ar); }
+
+	bool SerializeDeltaRotation(FArchive& Ar)
+	{
+		FVector RotationVector = QuatToRotationVector(MoveData.Rotation);
+		const bool bSuccess = SerializePackedVector<100, 16>(RotationVector, Ar);
+
+		if (Ar.IsLoading())
+		{
+			MoveData.Rotation = RotationVectorToQuat(RotationVector);
+		}
+
+		return bSuccess;
+	}
+};
+
+/* Enables Net Serialization of FRepPawnMoveCorrection */
+template<>
+struct TStructOpsTypeTraits<FRepPawnMoveCorrection> : public TStructOpsTypeTraitsBase
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
+
+/*
+* State of every non-root body of a multi-body pawn, relative to the root body. Bodies are in physics asset order.
+* PhysX joints hold no state of their own, so the relative poses and velocities fully describe the constraints between bodies.
+*/
+USTRUCT()
+struct FRepPawnBodySnapshot
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY() TArray<FRepPawnMoveData> Bodies;
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+	{
+		bOutSuccess = true;
+
+		// Single body pawns only pay for the flag
+		uint8 bHasBodies = Bodies.Num() > 0;
+		Ar.SerializeBits(&bHasBodies, 1);
+		if (!bHasBodies)
+		{
+			Bodies.Reset();
+			return true;
+		}
+
+		uint8 NumBodies = (uint8)FMath::Min(Bodies.Num(), 255);
+		Ar << NumBodies;
+		if (Ar.IsLoading())
+		{
+			Bodies.SetNum(NumBodies);
+		}
+
+		// Relative values are small, so the packed vectors stay short. Rotations are quantized to shorts.
+		for (int32 Idx = 0; Idx < NumBodies; Idx++)
+		{
+			FRepPawnMoveData& Body = Bodies[Idx];
+			bOutSuccess &= SerializePackedVector<100, 20>(Body.Location, Ar);
+
+			FRotator Rotation = Body.Rotation.Rotator();
+			Rotation.SerializeCompressedShort(Ar);
+			if (Ar.IsLoading())
+			{
+				Body.Rotation = Rotation.Quaternion();
+			}
+
+			bOutSuccess &= SerializePackedVector<100, 30>(Body.LinearVelocity, Ar);
+			bOutSuccess &= SerializePackedVector<100, 30>(Body.AngularVelocity, Ar);
+		}
+
+		return true;
+	}
+};
+
+/* Enables Net Serialization of FRepPawnBodySnapshot */
+template<>
+struct TStructOpsTypeTraits<FRepPawnBodySnapshot> : public TStructOpsTypeTraitsBase
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
+
 USTRUCT()
 struct FPawnMovementPostPhysicsTickFunction : public FTickFunction
 {
@@ -231,59 +452,204 @@ public:
 	bool bAckGoodMove;
 };
 
+///////////////////////////////
+///// Bandwidth Telemetry /////
+///////////////////////////////
+
+/* Movement RPC's we account bandwidth for */
+enum class ENTGame_MoveRPC : uint8
+{
+	ServerMove,
+	ClientAckGoodMove,
+	ClientAckBadMove,
+	ClientUpdateMoveLead,
+	MAX,
+};
+
+/* Payload bits written for a single RPC type, broken down by field. Doesn't include RPC header overhead. */
+struct NTGAME_API FNTGame_RPCBandwidth
+{
+	FNTGame_RPCBandwidth() { FMemory::Memzero(this, sizeof(FNTGame_RPCBandwidth)); }
+
+	uint32 NumCalls;
+	uint64 TotalBits;
+	uint64 TimeStampBits;
+	uint64 InputBits;
+	uint64 LocationBits;
+	uint64 RotationBits;
+	uint64 LinearVelocityBits;
+	uint64 AngularVelocityBits;
+	uint64 OtherBits;
+};
+
+/* Per-connection (i.e, per component) bandwidth accounting. Only records when NT.BandwidthTelemetry is enabled. */
+struct NTGAME_API FNTGame_BandwidthStats
+{
+	FNTGame_BandwidthStats()
+		: StartTime(0.f)
+	{}
+
+	FNTGame_RPCBandwidth RPCs[(uint8)ENTGame_MoveRPC::MAX];
+	float StartTime;
+
+	static bool IsEnabled();
+	static const TCHAR* GetRPCName(const ENTGame_MoveRPC InRPC);
+
+	void Reset(const float InStartTime);
+	void RecordServerMove(const FRepPlayerInput& InInput, const FRepPlayerInput* InLatestInput, const FRepPawnMoveData& InEndMoveData);
+	void RecordAckGoodMove();
+	void RecordAckBadMove(const FRepPawnMoveCorrection& InCorrection, const FRepPawnBodySnapshot& InServerEndBodies);
+	void RecordMoveLead();
+
+protected:
+	void RecordTimeStamp(FNTGame_RPCBandwidth& InRPC);
+	void RecordInput(FNTGame_RPCBandwidth& InRPC, const FRepPlayerInput& InInput);
+	void RecordMoveData(FNTGame_RPCBandwidth& InRPC, const FRepPawnMoveData& InMoveData);
+	void RecordMoveDelta(FNTGame_RPCBandwidth& InRPC, const FRepPawnMoveCorrection& InCorrection);
+};
+
 ///////////////////////////////////
 ///// Simplified Network Data /////
 ///////////////////////////////////
 
 typedef TSharedPtr<class FSavedPhysicsMove> FSavedPhysicsMovePtr;
 
-class NTGAME_API FSavedPhysicsMove
+/* Input sent ahead of the move that applies it, tagged with the timestamp of the move that carried it */
+struct FNTGame_FutureInput
+{
+	FNTGame_FutureInput()
+		: TimeStamp(0.f)
+		, Input(FRepPlayerInput())
+	{}
+
+	FNTGame_FutureInput(const float InTimeStamp, const FRepPlayerInput& InInput)
+		: TimeStamp(InTimeStamp)
+		, Input(InInput)
+	{}
+
+	float TimeStamp;
+	FRepPlayerInput Input;
+};
+
+/* Forces for one move, consumed by the physics callback over the substeps that follow it */
+struct FNTGame_MoveForces
+{
+	FNTGame_MoveForces()
+		: InputAccel(FVector::ZeroVector)
+		, AngularAccel(FVector::ZeroVector)
+		, HoverGroundZ(0.f)
+		, bHasHoverGround(false)
+		, RemainingTime(0.f)
+	{}
+
+	FVector InputAccel;
+	FVector AngularAccel;
+	float HoverGroundZ;
+	uint8 bHasHoverGround : 1;
+	float RemainingTime;		// Time worth of acceleration still to be applied
+};
+
+/*
+* The end state fills the first cache line, and the fields read by ack and replay loops share the second.
+* A move's start state is the end state of the move before it (or of the last acked move), so it isn't stored.
+*/
+MS_ALIGN(PLATFORM_CACHE_LINE_SIZE) class NTGAME_API FSavedPhysicsMove
 {
 public:
-	// Constructor / Destructor
 	FSavedPhysicsMove() {}
-	virtual ~FSavedPhysicsMove() {}
 
-	// Stored Data to replay this move
+	// Movement State after move is simulated
+	FRepPawnMoveData EndMoveData;
+
+	// Stored Data to replay this move. Physics steps over the move delta, acceleration is applied over the (time dilated) accel delta.
 	float MoveTimestamp;
 	float MoveDeltaTime;
+	float AccelDeltaTime;
 
 	// Input used for acceleration calculation for this move
 	FRepPlayerInput MoveInput;
 
-	// Movement States before / after move is simulated.
-	FRepPawnMoveData StartMoveData;
-	FRepPawnMoveData EndMoveData;
+	// Physics substeps the move was simulated with, so replays split it the same way
+	uint8 NumSubsteps;
 
 	// Don't use this yet, essentially used to combine moves together and save network bandwidth
 	uint8 bForceNoCombine : 1;
 	// Whether timestamp is invalid when we detect a timestamp discrepancy
 	uint8 bHasInvalidTimeStampWhenStampsReset : 1;
+	// Whether PhysX reported any contact for the body during this move. Contact-free moves can be replayed analytically.
+	uint8 bHadContact : 1;
 
 	void Clear();
-	void PreUpdate(const UNTGame_MovementComponent* InComponent);
 	void PostUpdate(const UNTGame_MovementComponent* InComponent);
 
 	bool IsImportantMove(const FSavedPhysicsMovePtr& LastAckedMove) const;
 	bool CanCombineWith(const FSavedPhysicsMovePtr& OtherPendingMove) const;
+} GCC_ALIGN(PLATFORM_CACHE_LINE_SIZE);
+
+/*
+* Saved moves for every movement component in a world, so that steady-state play never allocates. Moves go back to the pool
+* when their last shared reference is released, and prediction data keeps the pool alive while it holds any.
+* Moves are only created and saved on the game thread, so there is a single free list.
+*/
+class NTGAME_API FNTGame_SavedMovePool : public TSharedFromThis<FNTGame_SavedMovePool>, protected FNoncopyable
+{
+public:
+	/* Moves past this are freed rather than kept for reuse */
+	static const int32 MaxFreeMoves;
+
+	/* Pool for the given world, created on first use and dropped when the world is cleaned up */
+	static TSharedRef<FNTGame_SavedMovePool> Get(const UWorld* InWorld);
+
+	FNTGame_SavedMovePool() {}
+	~FNTGame_SavedMovePool();
+
+	/* Returns a cleared move */
+	FSavedPhysicsMovePtr Acquire();
+
+	FORCEINLINE int32 GetNumFree() const { return FreeMoves.Num(); }
+
+protected:
+	void ReturnMove(FSavedPhysicsMove* InMove);
+
+	static FSavedPhysicsMove* AllocateMove();
+	static void DestroyMove(FSavedPhysicsMove* InMove);
+	static void OnWorldCleanup(UWorld* InWorld, bool bSessionEnded, bool bCleanupResources);
+
+	TArray<FSavedPhysicsMove*> FreeMoves;
 };
 
 class NTGAME_API FNetworkPredictionData_Client_Physics : public FNetworkPredictionData_Client, protected FNoncopyable
 {
 public:
-	FNetworkPredictionData_Client_Physics();
-	virtual ~FNetworkPredictionData_Client_Physics() {}
+	FNetworkPredictionData_Client_Physics(const UWorld* InWorld);
+	virtual ~FNetworkPredictionData_Client_Physics();
 
-	static const int32 MaxFreeMoves;
 	static const int32 MaxSavedMoves;
+	static const int32 MinSavedMoves;
 	static const float MaxMoveDeltaTime;
 
 	float ClientUpdateTime;
 	float CurrentTimeStamp;
+	float TimeDilation;
 	uint8 bNeedsReplay : 1;
+	// Whether the last move sent to the server was at rest. Saved moves can't tell us, they're gone once acked.
+	uint8 bLastMoveAtRest : 1;
 
+	// Round trip estimate from move acks, used to size the move buffers
+	float SmoothedRTT;
+	float RTTVariance;
+	float AverageMoveDeltaTime;
+	int32 SavedMoveLimit;
+
+	// Lifetime correction results, for telemetry
+	uint32 NumCorrections;
+	uint32 NumMovesReplayed;
+
+	// Last correction applied, echoed back to the server with every move
+	uint8 LastCorrectionId;
+
+	TSharedPtr<FNTGame_SavedMovePool> MovePool;
 	TArray<FSavedPhysicsMovePtr> SavedMoves;
-	TArray<FSavedPhysicsMovePtr> FreeMoves;
 	FSavedPhysicsMovePtr PendingMove;
 	FSavedPhysicsMovePtr LastAckedMove;
 	FSavedPhysicsMovePtr CurrentMove;
@@ -291,26 +657,36 @@ public:
 	int32 GetMoveIndexFromTimeStamp(const float TimeStamp) const;
 	void AcknowledgeMove(const int32 AckMoveIndex);
 	void FreeMove(const FSavedPhysicsMovePtr& FreedMove);
-	FSavedPhysicsMovePtr AllocateNewMove() { return FSavedPhysicsMovePtr(new FSavedPhysicsMove()); }
 	FSavedPhysicsMovePtr CreateSavedMove();
 
 	float UpdateTimeStampAndDeltaTime(const float InDeltaTime, const float MinTimeBetweenResets);
+	void UpdateRoundTripTime(const float RTTSample);
+	void UpdateMoveLimits();
 };
 
 class NTGAME_API FNetworkPredictionData_Server_Physics : public FNetworkPredictionData_Server, protected FNoncopyable
 {
 public:
 	FNetworkPredictionData_Server_Physics(const UWorld* InWorld);
-	virtual ~FNetworkPredictionData_Server_Physics() {}
+	virtual ~FNetworkPredictionData_Server_Physics();
 	
 	float CurrentClientTimeStamp;
 	float LastUpdateTime;
 	float ServerTimeStampLastServerMove;
 
 	FSavedPhysicsMovePtr CurrentlyProcessingClientMove;
+	TSharedPtr<FNTGame_SavedMovePool> MovePool;
+	// Reused for every move the client sends
+	FSavedPhysicsMovePtr ProcessingMove;
+	// State the client reported at the end of the move being processed
+	FRepPawnMoveData ClientEndMoveData;
+	// Non-root bodies for the next correction. Only captured when one is sent.
+	FRepPawnBodySnapshot CorrectionBodies;
 
 	uint8 bForceClientUpdate : 1;
 	uint8 bResolvingTimeDiscrepancy : 1;
+	// Client reported it was at rest in it's last move, missing moves are expected
+	uint8 bClientAtRest : 1;
 
 	float LifetimeRawTimeDiscrepancy;
 	float TimeDiscrepancy;
@@ -318,6 +694,37 @@ public:
 	float TimeDiscrepancyAccumulatedClientDeltasSinceLastServerTick;
 	float WorldCreationTime;
 
+	// Input Extrapolation, used when client moves don't arrive in time
+	FRepPlayerInput LastClientInput;
+	float ExtrapolatedTime;
+	// Body state from before we started extrapolating
+	FRepPawnMoveData PreExtrapolationState;
+	FRepPawnBodySnapshot PreExtrapolationBodies;
+
+	// With input delay, the client sends inputs before it applies them. These are the inputs for the next moves, in timestamp order.
+	TArray<FNTGame_FutureInput> FutureClientInputs;
+	// How many of them extrapolation has used since the last move arrived
+	int32 NumFutureInputsUsed;
+
+	// How far client time leads server time, used to drive client time dilation
+	float ClientTimeLead;
+	float ClientTimeJitter;
+	// Real time the last move's packet was received, jitter is measured against it rather than the server's tick time
+	double LastMoveArrivalTime;
+	float LastTimeDilationUpdateTime;
+
+	// Seconds worth of out-of-tolerance client error, spent before a correction is sent
+	float AccumulatedClientError;
+
+	// Last correction sent, and the last one the client says it applied. While they differ, a correction is in flight.
+	uint8 PendingCorrectionId;
+	uint8 ClientAckedCorrectionId;
+	float PendingCorrectionTime;
+
+	// Lifetime move results, for benchmarking and telemetry
+	uint32 NumGoodMoves;
+	uint32 NumBadMoves;
+
 	float GetServerMoveDeltaTime(const float ClientTimeStamp) const;
 	float GetBaseServerMoveDeltaTime(const float ClientTimeStamp) const;
 
@@ -0,0 +1,127 @@
+// Copyright (C) James Baxter 2017. All Rights Reserved.
+
+#pragma once
+
+#include "GameFramework/Actor.h"
+#include "NTGame_NetScenario.generated.h"
+
+// Declarations
+class ANTGame_Pawn;
+
+/* Packet simulation settings held for a timed phase. Lag can ramp linearly to PktLagEnd over the phase. */
+USTRUCT()
+struct FNTGame_NetProfilePhase
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Config) FString Name;
+	UPROPERTY(Config) float Duration;
+
+	UPROPERTY(Config) int32 PktLag;
+	UPROPERTY(Config) int32 PktLagEnd;			// -1 holds PktLag for the whole phase
+	UPROPERTY(Config) int32 PktLagVariance;
+	UPROPERTY(Config) int32 PktLoss;
+	UPROPERTY(Config) int32 PktDup;
+	UPROPERTY(Config) bool bPktOrder;
+
+	FNTGame_NetProfilePhase()
+		: Duration(10.f)
+		, PktLag(0)
+		, PktLagEnd(-1)
+		, PktLagVariance(0)
+		, PktLoss(0)
+		, PktDup(0)
+		, bPktOrder(false)
+	{}
+};
+
+/* Named sequence of network phases, defined in DefaultGame.ini */
+USTRUCT()
+struct FNTGame_NetScenarioDef
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Config) FString Name;
+	UPROPERTY(Config) TArray<FNTGame_NetProfilePhase> Phases;
+};
+
+/* Results gathered for a single phase */
+struct FNTGame_NetScenarioResult
+{
+	FNTGame_NetScenarioResult()
+		: Duration(0.f)
+		, NumSamples(0)
+		, TotalBytesIn(0.f)
+		, TotalBytesOut(0.f)
+		, StartCorrections(0)
+		, StartMovesReplayed(0)
+		, StartMovementCycles(0)
+		, StartFrame(0)
+		, Corrections(0)
+		, MovesReplayed(0)
+		, MovementMS(0.f)
+	{}
+
+	FString Name;
+	float Duration;
+	int32 NumSamples;
+	float TotalBytesIn;
+	float TotalBytesOut;
+
+	uint32 StartCorrections;
+	uint32 StartMovesReplayed;
+	uint64 StartMovementCycles;
+	uint64 StartFrame;
+
+	uint32 Corrections;
+	uint32 MovesReplayed;
+	float MovementMS;		// Movement tick cost per frame
+};
+
+/*
+* Plays back timed network profiles (latency ramps, loss bursts, jitter spikes) through the net driver's packet simulation,
+* and records corrections, replay cost and bandwidth for each phase. Results are written as JSON to Saved/Benchmarks.
+* On a client, this measures the local pawn. On a server, it measures every pawn with a remote client.
+* Headless client: -game -nullrhi -ExecCmds="NT.Scenario <Name> [bot] [exit]"
+*/
+UCLASS(Transient, NotPlaceable, Config = Game)
+class NTGAME_API ANTGame_NetScenario : public AActor
+{
+	GENERATED_BODY()
+public:
+	ANTGame_NetScenario(const FObjectInitializer& OI);
+
+	virtual void Tick(float DeltaSeconds) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	bool StartScenario(const FString& InName, const bool bInScriptedInput, const bool bInExitWhenDone);
+
+	UPROPERTY(Config)
+	TArray<FNTGame_NetScenarioDef> Scenarios;
+
+protected:
+	FNTGame_NetScenarioDef ActiveScenario;
+	TArray<FNTGame_NetScenarioResult> Results;
+
+	int32 PhaseIndex;
+	float PhaseTime;
+	float ScriptTime;
+	uint8 bScriptedInput : 1;
+	uint8 bExitWhenDone : 1;
+	uint8 bRunning : 1;
+
+	/* Whatever the net driver was using before the scenario, restored when it ends */
+	FPacketSimulationSettings SavedPacketSettings;
+
+	void BeginPhase(const int32 InPhaseIndex);
+	void EndPhase();
+	void FinishScenario();
+
+	void ApplyPhaseSettings(const FNTGame_NetProfilePhase& InPhase, const float InAlpha) const;
+	void ResetPacketSettings() const;
+
+	void SamplePhase(FNTGame_NetScenarioResult& Result) const;
+	void GetMoveTotals(uint32& OutCorrections, uint32& OutMovesReplayed, uint64& OutMovementCycles) const;
+	ANTGame_Pawn* GetLocalPawn() const;
+	void WriteResults() const;
+};
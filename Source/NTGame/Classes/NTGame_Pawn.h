@@ -15,10 +15,14 @@ class NTGAME_API ANTGame_Pawn : public APawn
 public:
 	ANTGame_Pawn(const FObjectInitializer& OI);
 
+	/* Name of the root component. Subclasses can swap the skeletal mesh for a simple shape with OI.SetDefaultSubobjectClass. */
+	static FName RootMeshName;
+
 	///////////////////////////
 	///// APawn Interface /////
 	///////////////////////////
 
+	virtual void BeginPlay() override;
 	virtual void Tick(float DeltaSeconds) override;
 	virtual void SetupPlayerInputComponent(UInputComponent* PlayerInputComponent) override;
 	virtual void GetLifetimeReplicatedProps(TArray<class FLifetimeProperty> & OutLifetimeProps) const override;
@@ -28,7 +32,9 @@ public:
 	///// Accessors /////
 	/////////////////////
 
-	FORCEINLINE USkeletalMeshComponent* GetRootMesh() const { return RootMesh; }
+	FORCEINLINE UPrimitiveComponent* GetRootPrimitive() const { return RootMesh; }
+	/* Null when the root is a simple shape */
+	FORCEINLINE USkeletalMeshComponent* GetRootMesh() const { return Cast<USkeletalMeshComponent>(RootMesh); }
 	FORCEINLINE UNTGame_MovementComponent* GetPhysicsMovement() const { return PhysicsMovement; }
 	FORCEINLINE USpringArmComponent* GetCameraSpringArm() const { return CameraSpringArm; }
 	FORCEINLINE UCameraComponent* GetViewCamera() const { return ViewCamera; }
@@ -42,13 +48,34 @@ public:
 	virtual void PostNetReceiveVelocity(const FVector& NewVelocity);
 	virtual void PostNetReceiveAngularVelocity(const FVector& NewAndVelocity);
 
+	///////////////////
+	///// Pooling /////
+	///////////////////
+
+	/* Takes the pawn out of play without destroying it, so the game mode can hand it to the next player */
+	void DeactivateToPool();
+	/* Puts a pooled pawn back into play at the given spot */
+	void ActivateFromPool(const FVector& InLocation, const FRotator& InRotation);
+
+	FORCEINLINE bool IsPooled() const { return bIsPooled; }
+
 protected:
+	UPROPERTY(Transient, ReplicatedUsing = OnRep_IsPooled)
+	uint8 bIsPooled : 1;
+
+	/* Physics and prediction state aren't replicated, so clients apply their half of pooling here */
+	UFUNCTION()
+	void OnRep_IsPooled();
+
+	/* Movement, physics and tick state shared by server and clients */
+	void ApplyPooledState();
+
 	//////////////////////
 	///// Components /////
 	//////////////////////
 
 	UPROPERTY(VisibleDefaultsOnly, Category = "Components")
-	USkeletalMeshComponent* RootMesh;
+	UPrimitiveComponent* RootMesh;
 	UPROPERTY(VisibleDefaultsOnly, Category = "Components")
 	UNTGame_MovementComponent* PhysicsMovement;
 	UPROPERTY(VisibleDefaultsOnly, Category = "Components")
@@ -56,6 +83,25 @@ protected:
 	UPROPERTY(VisibleDefaultsOnly, Category = "Components")
 	UCameraComponent* ViewCamera;
 
+	/////////////////
+	///// Debug /////
+	/////////////////
+
+	/* Draw this pawn's net roles above it. Never drawn on dedicated servers, and compiled out with debug drawing. */
+	UPROPERTY(EditDefaultsOnly, Category = "Debug")
+	uint8 bDrawDebugRoles : 1;
+
+	//////////////////
+	///// Server /////
+	//////////////////
+
+	/* On dedicated servers, skip camera and mesh work that only matters to a viewer */
+	UPROPERTY(EditDefaultsOnly, Category = "Server")
+	uint8 bLeanDedicatedServer : 1;
+
+	bool IsLeanServer() const;
+	bool ShouldTickCameraSpringArm() const;
+
 	/////////////////
 	///// Input /////
 	/////////////////
@@ -0,0 +1,78 @@
+// Copyright (C) James Baxter 2017. All Rights Reserved.
+// Fixed-rate sampling of movement telemetry into ring buffers, for the debug overlay.
+
+#pragma once
+
+// Declarations
+class UNTGame_MovementComponent;
+class UNetConnection;
+
+/* Sampled Channels */
+enum class ENTGame_TelemetryChannel : uint8
+{
+	RTT,				// ms
+	ReplayLength,		// Saved moves that would be replayed on a correction
+	CorrectionRate,		// Corrections per second
+	BytesPerSecond,		// Connection In + Out
+	MovementMS,			// Movement tick cost per frame
+	Speed,
+	MAX,
+};
+
+/* Ring buffer of samples for a single channel */
+struct NTGAME_API FNTGame_TelemetryChannel
+{
+	static const int32 Capacity = 64;
+
+	FNTGame_TelemetryChannel()
+		: Head(0)
+		, Count(0)
+	{
+		FMemory::Memzero(Samples);
+	}
+
+	void Push(const float InValue)
+	{
+		Samples[Head] = InValue;
+		Head = (Head + 1) % Capacity;
+		Count = FMath::Min(Count + 1, Capacity);
+	}
+
+	/* Samples in order, oldest first */
+	FORCEINLINE float GetSample(const int32 InIndex) const { return Samples[(Head - Count + InIndex + Capacity) % Capacity]; }
+	FORCEINLINE float GetLatest() const { return Count > 0 ? GetSample(Count - 1) : 0.f; }
+	FORCEINLINE int32 Num() const { return Count; }
+
+	float GetMax() const;
+
+protected:
+	float Samples[Capacity];
+	int32 Head;
+	int32 Count;
+};
+
+/* Samples a movement component and its connection at a fixed rate */
+class NTGAME_API FNTGame_TelemetrySampler
+{
+public:
+	FNTGame_TelemetrySampler();
+
+	static const TCHAR* GetChannelName(const ENTGame_TelemetryChannel InChannel);
+
+	/* Returns true when a new sample was taken */
+	bool Tick(const float InDeltaTime, const UNTGame_MovementComponent* InMoveComp, const UNetConnection* InConnection);
+
+	FORCEINLINE const FNTGame_TelemetryChannel& GetChannel(const ENTGame_TelemetryChannel InChannel) const { return Channels[(uint8)InChannel]; }
+
+	float SampleInterval;
+
+protected:
+	void TakeSample(const float InElapsed, const UNTGame_MovementComponent* InMoveComp, const UNetConnection* InConnection);
+
+	FNTGame_TelemetryChannel Channels[(uint8)ENTGame_TelemetryChannel::MAX];
+
+	float TimeSinceSample;
+	uint64 LastMovementCycles;
+	uint64 LastFrameCounter;
+	uint32 LastNumCorrections;
+};
@@ -0,0 +1,29 @@
+// Copyright (C) James Baxter 2017. All Rights Reserved.
+
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+#include "NTGame_TraceReplayCommandlet.generated.h"
+
+// Declarations
+struct FNTGame_MoveTrace;
+
+/*
+* Re-simulates a recorded move trace headless against its map, and reports where the client and server first diverged,
+* and where the re-simulation first diverged from the recorded server results.
+* Usage: -run=NTGame_TraceReplay -Trace=<File.nttrace> [-Tolerance=<cm>]
+*/
+UCLASS()
+class NTGAME_API UNTGame_TraceReplayCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+public:
+	UNTGame_TraceReplayCommandlet(const FObjectInitializer& OI);
+
+	virtual int32 Main(const FString& Params) override;
+
+protected:
+	UWorld* LoadTraceWorld(const FString& InMapName) const;
+	void ReportClientDivergence(const FNTGame_MoveTrace& InTrace, const float InTolerance) const;
+	bool ReplayTrace(UWorld* InWorld, const FNTGame_MoveTrace& InTrace, const float InTolerance) const;
+};
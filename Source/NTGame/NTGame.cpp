@@ -3,4 +3,20 @@
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, NTGame, "NTGame" );
 
 DEFINE_LOG_CATEGORY(LogNTGame)
-DEFINE_LOG_CATEGORY(LogNTGameMovement)
\ No newline at end of file
+DEFINE_LOG_CATEGORY(LogNTGameMovement)
+
+DEFINE_STAT(STAT_NTMovement_PerformMovement);
+DEFINE_STAT(STAT_NTMovement_CalculateInputAcceleration);
+DEFINE_STAT(STAT_NTMovement_ReplayMove);
+DEFINE_STAT(STAT_NTMovement_ClientReplayBadMoves);
+DEFINE_STAT(STAT_NTMovement_ServerMove);
+DEFINE_STAT(STAT_NTMovement_ServerMovePostSim);
+DEFINE_STAT(STAT_NTMovement_NetSerializeInput);
+DEFINE_STAT(STAT_NTMovement_NetSerializeMoveData);
+
+DEFINE_STAT(STAT_NTMovement_MovesSaved);
+DEFINE_STAT(STAT_NTMovement_MovesReplayed);
+DEFINE_STAT(STAT_NTMovement_MovesReplayedAnalytically);
+DEFINE_STAT(STAT_NTMovement_MovesAcked);
+DEFINE_STAT(STAT_NTMovement_MovesCorrected);
+DEFINE_STAT(STAT_NTMovement_CorrectionsHeld);
\ No newline at end of file
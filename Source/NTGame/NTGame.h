@@ -6,6 +6,25 @@
 
 #include "UMG.h"
 
+// Stats
+DECLARE_STATS_GROUP(TEXT("NTMovement"), STATGROUP_NTMovement, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Perform Movement"), STAT_NTMovement_PerformMovement, STATGROUP_NTMovement, NTGAME_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Calculate Input Acceleration"), STAT_NTMovement_CalculateInputAcceleration, STATGROUP_NTMovement, NTGAME_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Replay Move"), STAT_NTMovement_ReplayMove, STATGROUP_NTMovement, NTGAME_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Client Replay Bad Moves"), STAT_NTMovement_ClientReplayBadMoves, STATGROUP_NTMovement, NTGAME_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Server Move"), STAT_NTMovement_ServerMove, STATGROUP_NTMovement, NTGAME_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Server Move PostSim"), STAT_NTMovement_ServerMovePostSim, STATGROUP_NTMovement, NTGAME_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("NetSerialize Input"), STAT_NTMovement_NetSerializeInput, STATGROUP_NTMovement, NTGAME_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("NetSerialize Move Data"), STAT_NTMovement_NetSerializeMoveData, STATGROUP_NTMovement, NTGAME_API);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Moves Saved"), STAT_NTMovement_MovesSaved, STATGROUP_NTMovement, NTGAME_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Moves Replayed"), STAT_NTMovement_MovesReplayed, STATGROUP_NTMovement, NTGAME_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Moves Replayed Analytically"), STAT_NTMovement_MovesReplayedAnalytically, STATGROUP_NTMovement, NTGAME_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Moves Acked"), STAT_NTMovement_MovesAcked, STATGROUP_NTMovement, NTGAME_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Moves Corrected"), STAT_NTMovement_MovesCorrected, STATGROUP_NTMovement, NTGAME_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Corrections Held"), STAT_NTMovement_CorrectionsHeld, STATGROUP_NTMovement, NTGAME_API);
+
 #include "NTGameClasses.h"
 #include "Net/UnrealNetwork.h"
 
@@ -0,0 +1,169 @@
+// Copyright (C) James Baxter 2017. All Rights Reserved.
+
+// Replays moves that had no contacts without stepping the physics scene. The integrator follows PhysX 3.4's
+// unconstrained body update (gravity, damping, velocity clamp, then semi-implicit integration about the centre of mass).
+
+#include "NTGame.h"
+#include "NTGame_MovementComponent.h"
+
+// PhysX
+#include "PhysXPublic.h"
+
+//////////////////////////
+///// Contact Events /////
+//////////////////////////
+
+void UNTGame_MovementComponent::SetUpdatedComponent(USceneComponent* NewUpdatedComponent)
+{
+	if (UpdatedPrimitive)
+	{
+		UpdatedPrimitive->OnComponentHit.RemoveDynamic(this, &UNTGame_MovementComponent::OnUpdatedPrimitiveHit);
+	}
+
+	Super::SetUpdatedComponent(NewUpdatedComponent);
+
+	// PhysX only reports contacts for bodies that ask for them
+	if (UpdatedPrimitive)
+	{
+		UpdatedPrimitive->SetNotifyRigidBodyCollision(true);
+		UpdatedPrimitive->OnComponentHit.AddUniqueDynamic(this, &UNTGame_MovementComponent::OnUpdatedPrimitiveHit);
+	}
+}
+
+void UNTGame_MovementComponent::OnUpdatedPrimitiveHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
+{
+	// Dispatched at the end of physics, once per frame for as long as the contact persists
+	bHadContactThisFrame = true;
+}
+
+//////////////////////
+///// Integrator /////
+//////////////////////
+
+static void IntegrateRigidBody(PxRigidDynamic* PRigidDynamic, const float DeltaTime, const PxVec3& LinearDeltaV, const PxVec3& AngularDeltaV)
+{
+	const PxTransform CMassLocalPose = PRigidDynamic->getCMassLocalPose();
+	PxTransform BodyPose = PRigidDynamic->getGlobalPose() * CMassLocalPose;
+
+	// Impulses land before the step, same as PhysX
+	PxVec3 LinearVelocity = PRigidDynamic->getLinearVelocity() + LinearDeltaV;
+	PxVec3 AngularVelocity = PRigidDynamic->getAngularVelocity() + AngularDeltaV;
+
+	if (!(PRigidDynamic->getActorFlags() & PxActorFlag::eDISABLE_GRAVITY))
+	{
+		LinearVelocity += PRigidDynamic->getScene()->getGravity() * DeltaTime;
+	}
+
+	// Damping is a linear approximation, clamped so it can't reverse the body
+	LinearVelocity *= PxMax(1.f - PRigidDynamic->getLinearDamping() * DeltaTime, 0.f);
+	AngularVelocity *= PxMax(1.f - PRigidDynamic->getAngularDamping() * DeltaTime, 0.f);
+
+	const PxReal MaxAngularVelocity = PRigidDynamic->getMaxAngularVelocity();
+	const PxReal AngularSpeedSq = AngularVelocity.magnitudeSquared();
+	if (AngularSpeedSq > MaxAngularVelocity * MaxAngularVelocity)
+	{
+		AngularVelocity *= MaxAngularVelocity / PxSqrt(AngularSpeedSq);
+	}
+
+	// Integrate position, then rotation about the centre of mass
+	BodyPose.p += LinearVelocity * DeltaTime;
+
+	const PxReal AngularSpeed = AngularVelocity.magnitude();
+	if (AngularSpeed > 0.f)
+	{
+		const PxReal HalfAngle = AngularSpeed * DeltaTime * 0.5f;
+		const PxVec3 Axis = AngularVelocity * (PxSin(HalfAngle) / AngularSpeed);
+
+		PxQuat Rotation = PxQuat(Axis.x, Axis.y, Axis.z, 0.f) * BodyPose.q;
+		Rotation += BodyPose.q * PxCos(HalfAngle);
+		BodyPose.q = Rotation.getNormalized();
+	}
+
+	PRigidDynamic->setGlobalPose(BodyPose * CMassLocalPose.getInverse());
+	PRigidDynamic->setLinearVelocity(LinearVelocity);
+	PRigidDynamic->setAngularVelocity(AngularVelocity);
+}
+
+/////////////////////////////
+///// Analytical Replay /////
+/////////////////////////////
+
+bool UNTGame_MovementComponent::ReplayMoveAnalytically(const FSavedPhysicsMovePtr& InMove)
+{
+	FBodyInstance* BodyInstance = UpdatedPrimitive ? UpdatedPrimitive->GetBodyInstance() : nullptr;
+	PxRigidDynamic* PRigidDynamic = BodyInstance ? BodyInstance->GetPxRigidDynamic_AssumesLocked() : nullptr;
+	PxScene* PScene = PRigidDynamic ? PRigidDynamic->getScene() : nullptr;
+	if (PScene == nullptr) { return false; }
+
+	PxTransform StartPose;
+	PxVec3 StartLinearVelocity;
+	PxVec3 StartAngularVelocity;
+
+	// Queued forces are consumed as we go, keep them in case the scene has to replay the move after all
+	const bool bSubstepForces = IsApplyingForcesPerSubstep();
+	const TArray<FNTGame_MoveForces> StartForces = bSubstepForces ? PendingForces : TArray<FNTGame_MoveForces>();
+
+	{
+		SCOPED_SCENE_WRITE_LOCK(PScene);
+
+		// Anything held by joints, locked axes or sleeping needs the solver
+		if (PRigidDynamic->isSleeping() || PRigidDynamic->getNbConstraints() > 0 || PRigidDynamic->getRigidDynamicLockFlags()
+			|| (PRigidDynamic->getRigidBodyFlags() & PxRigidBodyFlag::eKINEMATIC))
+		{
+			return false;
+		}
+
+		StartPose = PRigidDynamic->getGlobalPose();
+		StartLinearVelocity = PRigidDynamic->getLinearVelocity();
+		StartAngularVelocity = PRigidDynamic->getAngularVelocity();
+
+		const int32 StepCount = FMath::Max<int32>(InMove->NumSubsteps, 1);
+		const float StepDelta = InMove->MoveDeltaTime / (float)StepCount;
+
+		for (int32 StepIdx = 0; StepIdx < StepCount; StepIdx++)
+		{
+			FVector LinearDeltaV = FVector::ZeroVector;
+			FVector AngularDeltaV = FVector::ZeroVector;
+
+			if (bSubstepForces)
+			{
+				ComputePendingDeltaV(StepDelta, StepIdx == StepCount - 1, PRigidDynamic->getGlobalPose().p.z, PRigidDynamic->getLinearVelocity().z, LinearDeltaV, AngularDeltaV);
+			}
+
+			IntegrateRigidBody(PRigidDynamic, StepDelta, U2PVector(LinearDeltaV), U2PVector(FMath::DegreesToRadians(AngularDeltaV)));
+		}
+	}
+
+	// The contact flag only covers the original simulation, make sure the corrected path is still clear
+	const FTransform StartTransform = P2UTransform(StartPose);
+	const FTransform EndTransform = BodyInstance->GetUnrealWorldTransform();
+
+	FCollisionQueryParams QueryParams = FCollisionQueryParams();
+	FCollisionResponseParams ResponseParams = FCollisionResponseParams();
+	UpdatedPrimitive->InitSweepCollisionParams(QueryParams, ResponseParams);
+	QueryParams.AddIgnoredActor(GetOwner());
+
+	const bool bBlocked = GetWorld()->SweepTestByChannel(StartTransform.GetLocation(), EndTransform.GetLocation(), EndTransform.GetRotation(), UpdatedPrimitive->GetCollisionObjectType(), UpdatedPrimitive->GetCollisionShape(AnalyticalReplaySweepMargin), QueryParams, ResponseParams);
+	if (bBlocked)
+	{
+		{
+			SCOPED_SCENE_WRITE_LOCK(PScene);
+			PRigidDynamic->setGlobalPose(StartPose);
+			PRigidDynamic->setLinearVelocity(StartLinearVelocity);
+			PRigidDynamic->setAngularVelocity(StartAngularVelocity);
+		}
+
+		if (bSubstepForces)
+		{
+			PendingForces = StartForces;
+		}
+
+		// Further replays of this move go straight to the scene
+		InMove->bHadContact = true;
+		return false;
+	}
+
+	bComponentNeedsSync = true;
+	INC_DWORD_STAT(STAT_NTMovement_MovesReplayedAnalytically);
+	return true;
+}
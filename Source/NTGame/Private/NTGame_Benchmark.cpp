@@ -0,0 +1,448 @@
+// Copyright (C) James Baxter 2017. All Rights Reserved.
+
+#include "NTGame.h"
+#include "NTGame_Benchmark.h"
+
+#include "NTGame_Pawn.h"
+#include "NTGame_MovementComponent.h"
+
+// Json
+#include "Serialization/JsonWriter.h"
+#include "Policies/PrettyJsonPrintPolicy.h"
+
+///////////////////////////
+///// Console Command /////
+///////////////////////////
+
+static void StartNTBenchmark(const TArray<FString>& Args, UWorld* World)
+{
+	if (World == nullptr || World->GetNetMode() == NM_Client)
+	{
+		UE_LOG(LogNTGame, Warning, TEXT("NT.Benchmark must be run on a server"));
+		return;
+	}
+
+	const int32 MaxPawns = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 64;
+	const int32 PawnStep = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 8;
+	const float PhaseDuration = Args.Num() > 2 ? FCString::Atof(*Args[2]) : 10.f;
+	const bool bExitWhenDone = Args.Num() > 3 && Args[3] == TEXT("exit");
+
+	FActorSpawnParameters SpawnInfo;
+	SpawnInfo.ObjectFlags |= RF_Transient;
+
+	ANTGame_Benchmark* Benchmark = World->SpawnActor<ANTGame_Benchmark>(SpawnInfo);
+	ASSERTV(Benchmark != nullptr, TEXT("Unable To Spawn Benchmark"));
+
+	Benchmark->StartBenchmark(MaxPawns, PawnStep, PhaseDuration, bExitWhenDone);
+}
+
+static FAutoConsoleCommandWithWorldAndArgs NTBenchmarkCommand(
+	TEXT("NT.Benchmark"),
+	TEXT("Server load benchmark. NT.Benchmark <MaxPawns> <Step> <PhaseSeconds> [exit]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&StartNTBenchmark));
+
+////////////////////////
+///// Construction /////
+////////////////////////
+
+ANTGame_Benchmark::ANTGame_Benchmark(const FObjectInitializer& OI)
+	: Super(OI)
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = true;
+	PrimaryActorTick.bAllowTickOnDedicatedServer = true;
+	PrimaryActorTick.TickGroup = ETickingGroup::TG_PrePhysics;
+
+	bReplicates = false;
+
+	MaxPawns = 64;
+	PawnStep = 8;
+	PhaseDuration = 10.f;
+	WarmupDuration = 2.f;
+	BotRoundTripTime = 0.1f;
+	PhaseTime = 0.f;
+	ScriptTime = 0.f;
+	bExitWhenDone = false;
+	bRunning = false;
+	bSpawnFailed = false;
+	PrevBandwidthTelemetry = 0;
+}
+
+void ANTGame_Benchmark::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	DestroyBotPawns();
+	Super::EndPlay(EndPlayReason);
+}
+
+/////////////////////
+///// Benchmark /////
+/////////////////////
+
+void ANTGame_Benchmark::StartBenchmark(const int32 InMaxPawns, const int32 InPawnStep, const float InPhaseDuration, const bool bInExitWhenDone)
+{
+	MaxPawns = FMath::Max(InMaxPawns, 1);
+	PawnStep = FMath::Max(InPawnStep, 1);
+	PhaseDuration = FMath::Max(InPhaseDuration, 1.f);
+	bExitWhenDone = bInExitWhenDone;
+	bRunning = true;
+	bSpawnFailed = false;
+
+	// Bot bandwidth is measured by the movement telemetry
+	IConsoleVariable* TelemetryCVar = IConsoleManager::Get().FindConsoleVariable(TEXT("NT.BandwidthTelemetry"));
+	if (TelemetryCVar)
+	{
+		PrevBandwidthTelemetry = TelemetryCVar->GetInt();
+		TelemetryCVar->Set(1);
+	}
+
+	UE_LOG(LogNTGame, Log, TEXT("Starting NT Benchmark: %d pawns in steps of %d, %f seconds per step"), MaxPawns, PawnStep, PhaseDuration);
+
+	Phases.Reset();
+	BeginPhase(FMath::Min(PawnStep, MaxPawns));
+}
+
+void ANTGame_Benchmark::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	if (!bRunning || Phases.Num() == 0) { return; }
+
+	ScriptTime += DeltaSeconds;
+	PhaseTime += DeltaSeconds;
+
+	DriveBotPawns(DeltaSeconds);
+
+	// Let physics settle after spawning before we record anything
+	if (PhaseTime < WarmupDuration) { return; }
+
+	FNTGame_BenchmarkPhase& CurrentPhase = Phases.Last();
+	if (CurrentPhase.NumSamples == 0)
+	{
+		GetTotalMoveResults(CurrentPhase.StartGoodMoves, CurrentPhase.StartBadMoves);
+		GetTotalBotBits(CurrentPhase.StartBotBitsIn, CurrentPhase.StartBotBitsOut);
+	}
+
+	SamplePhase(CurrentPhase);
+	CurrentPhase.Duration += DeltaSeconds;
+
+	if (CurrentPhase.Duration >= PhaseDuration)
+	{
+		EndPhase();
+
+		// If we couldn't spawn every bot this phase, the next won't do any better
+		const int32 NextNumPawns = CurrentPhase.NumPawns + PawnStep;
+		if (CurrentPhase.NumPawns >= MaxPawns || bSpawnFailed)
+		{
+			FinishBenchmark();
+		}
+		else
+		{
+			BeginPhase(FMath::Min(NextNumPawns, MaxPawns));
+		}
+	}
+}
+
+void ANTGame_Benchmark::BeginPhase(const int32 NumPawns)
+{
+	SpawnBotPawns(NumPawns);
+
+	FNTGame_BenchmarkPhase NewPhase = FNTGame_BenchmarkPhase();
+	NewPhase.NumPawns = BotPawns.Num();
+	Phases.Add(NewPhase);
+
+	PhaseTime = 0.f;
+}
+
+void ANTGame_Benchmark::EndPhase()
+{
+	FNTGame_BenchmarkPhase& CurrentPhase = Phases.Last();
+
+	uint32 TotalGoodMoves = 0;
+	uint32 TotalBadMoves = 0;
+	GetTotalMoveResults(TotalGoodMoves, TotalBadMoves);
+
+	CurrentPhase.GoodMoves = TotalGoodMoves - CurrentPhase.StartGoodMoves;
+	CurrentPhase.BadMoves = TotalBadMoves - CurrentPhase.StartBadMoves;
+
+	uint64 TotalBitsIn = 0;
+	uint64 TotalBitsOut = 0;
+	GetTotalBotBits(TotalBitsIn, TotalBitsOut);
+
+	CurrentPhase.BotBitsIn = TotalBitsIn - CurrentPhase.StartBotBitsIn;
+	CurrentPhase.BotBitsOut = TotalBitsOut - CurrentPhase.StartBotBitsOut;
+
+	const float AvgTickMS = CurrentPhase.NumSamples > 0 ? CurrentPhase.TotalTickMS / CurrentPhase.NumSamples : 0.f;
+	UE_LOG(LogNTGame, Log, TEXT("NT Benchmark: %d pawns, %f ms avg tick, %f ms max tick, %u corrections"), CurrentPhase.NumPawns, AvgTickMS, CurrentPhase.MaxTickMS, CurrentPhase.BadMoves);
+}
+
+void ANTGame_Benchmark::FinishBenchmark()
+{
+	bRunning = false;
+
+	WriteResults();
+	DestroyBotPawns();
+
+	IConsoleVariable* TelemetryCVar = IConsoleManager::Get().FindConsoleVariable(TEXT("NT.BandwidthTelemetry"));
+	if (TelemetryCVar)
+	{
+		TelemetryCVar->Set(PrevBandwidthTelemetry);
+	}
+
+	if (bExitWhenDone)
+	{
+		FPlatformMisc::RequestExit(false);
+	}
+	else
+	{
+		Destroy();
+	}
+}
+
+////////////////
+///// Bots /////
+////////////////
+
+void ANTGame_Benchmark::SpawnBotPawns(const int32 NumPawns)
+{
+	UClass* PawnClass = ANTGame_Pawn::StaticClass();
+
+	const AGameModeBase* WorldGM = GetWorld()->GetAuthGameMode();
+	if (WorldGM && WorldGM->DefaultPawnClass && WorldGM->DefaultPawnClass->IsChildOf(ANTGame_Pawn::StaticClass()))
+	{
+		PawnClass = WorldGM->DefaultPawnClass;
+	}
+
+	// Lay bots out in a grid around the first player start
+	FVector Origin = FVector(0.f, 0.f, 500.f);
+	for (TActorIterator<APlayerStart> StartItr(GetWorld()); StartItr; ++StartItr)
+	{
+		Origin = StartItr->GetActorLocation();
+		break;
+	}
+
+	FActorSpawnParameters SpawnInfo;
+	SpawnInfo.ObjectFlags |= RF_Transient;
+	SpawnInfo.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	const int32 GridWidth = 16;
+	const float GridSpacing = 400.f;
+
+	while (BotPawns.Num() < NumPawns)
+	{
+		const int32 Idx = BotPawns.Num();
+		const FVector Offset = FVector((Idx % GridWidth) * GridSpacing, (Idx / GridWidth) * GridSpacing, 0.f);
+
+		ANTGame_Pawn* NewBot = GetWorld()->SpawnActor<ANTGame_Pawn>(PawnClass, Origin + Offset, FRotator::ZeroRotator, SpawnInfo);
+		if (NewBot == nullptr)
+		{
+			UE_LOG(LogNTGame, Warning, TEXT("NT Benchmark: Failed to spawn bot pawn %d"), Idx);
+			bSpawnFailed = true;
+			break;
+		}
+
+		// Bots act as remote clients, so the server processes and checks their moves like any other. With no connection, nothing is sent back.
+		NewBot->SetAutonomousProxy(true);
+
+		BotPawns.Add(NewBot);
+		BotClients.Add(FNTGame_BenchmarkBot());
+	}
+}
+
+void ANTGame_Benchmark::DestroyBotPawns()
+{
+	for (ANTGame_Pawn* BotPawn : BotPawns)
+	{
+		if (BotPawn && !BotPawn->IsPendingKill())
+		{
+			BotPawn->Destroy();
+		}
+	}
+
+	BotPawns.Reset();
+	BotClients.Reset();
+}
+
+void ANTGame_Benchmark::DriveBotPawns(const float DeltaSeconds)
+{
+	// Scripted input, every bot is offset so they don't all do the same thing
+	for (int32 Idx = 0; Idx < BotPawns.Num(); Idx++)
+	{
+		const ANTGame_Pawn* BotPawn = BotPawns[Idx];
+		if (BotPawn == nullptr) { continue; }
+
+		UNTGame_MovementComponent* BotMovement = BotPawn->GetPhysicsMovement();
+		ASSERTV(BotMovement != nullptr, TEXT("Invalid Bot Movement"));
+
+		FNetworkPredictionData_Server_Physics* ServerData = BotMovement->GetPredictionData_Server_Physics();
+		ASSERTV(ServerData != nullptr, TEXT("Invalid Bot Server Data"));
+
+		// Same timestamp handling as a real client
+		FNTGame_BenchmarkBot& BotClient = BotClients[Idx];
+		if (BotClient.TimeStamp > UNTGame_MovementComponent::MinTimeBetweenTimeStampResets)
+		{
+			BotClient.TimeStamp = 0.f;
+		}
+		BotClient.TimeStamp += DeltaSeconds;
+
+		// Corrections aren't sent to bots, so they only acknowledge one a round trip after the server made it
+		const float WorldTime = GetWorld()->GetTimeSeconds();
+		if (ServerData->PendingCorrectionId != BotClient.ReceivedCorrectionId)
+		{
+			BotClient.ReceivedCorrectionId = ServerData->PendingCorrectionId;
+			BotClient.CorrectionArrivalTime = WorldTime + BotRoundTripTime;
+		}
+		if (WorldTime >= BotClient.CorrectionArrivalTime)
+		{
+			BotClient.AckedCorrectionId = BotClient.ReceivedCorrectionId;
+		}
+
+		// Input and end state are snapped to what would come off the wire
+		FRepPlayerInput BotInput = GetScriptedInput(ScriptTime + (float)Idx);
+		bool bSuccess = true;
+		FBitWriter InputWriter(64, true);
+		BotInput.NetSerialize(InputWriter, nullptr, bSuccess);
+		FBitReader InputReader(InputWriter.GetData(), InputWriter.GetNumBits());
+		BotInput.NetSerialize(InputReader, nullptr, bSuccess);
+
+		// Bots don't predict, they report a dead-reckoned guess from the server's state
+		FRepPawnMoveData EndMoveData = BotMovement->GetCurrentMoveData();
+		EndMoveData.Location += EndMoveData.LinearVelocity * DeltaSeconds;
+		EndMoveData.Quantize();
+
+		const FRepPlayerInput* LatestInput = BotMovement->InputDelayFrames > 0 ? &BotInput : nullptr;
+		BotMovement->BandwidthStats.RecordServerMove(BotInput, LatestInput, EndMoveData);
+		BotMovement->ServerProcessMove(BotClient.TimeStamp, BotInput, LatestInput, EndMoveData, BotClient.AckedCorrectionId);
+	}
+}
+
+FRepPlayerInput ANTGame_Benchmark::GetScriptedInput(const float InTime)
+{
+	FRepPlayerInput ScriptedInput = FRepPlayerInput();
+	ScriptedInput.ForwardAxis = FMath::Sin(InTime * 0.5f);
+	ScriptedInput.StrafeAxis = FMath::Cos(InTime * 0.3f) * 0.5f;
+	ScriptedInput.SteerAxis = FMath::Sin(InTime * 0.7f) * 0.5f;
+	return ScriptedInput;
+}
+
+void ANTGame_Benchmark::DriveScriptedInput(UNTGame_MovementComponent* InMovement, const float InTime)
+{
+	const FRepPlayerInput ScriptedInput = GetScriptedInput(InTime);
+	InMovement->SetForwardInput(ScriptedInput.ForwardAxis);
+	InMovement->SetStrafeInput(ScriptedInput.StrafeAxis);
+	InMovement->SetSteerInput(ScriptedInput.SteerAxis);
+}
+
+///////////////////
+///// Results /////
+///////////////////
+
+void ANTGame_Benchmark::SamplePhase(FNTGame_BenchmarkPhase& Phase)
+{
+	const float TickMS = FPlatformTime::ToMilliseconds(GGameThreadTime);
+	Phase.TotalTickMS += TickMS;
+	Phase.MaxTickMS = FMath::Max(Phase.MaxTickMS, TickMS);
+	Phase.NumSamples++;
+
+	const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	if (NetDriver)
+	{
+		Phase.NumConnections = FMath::Max(Phase.NumConnections, NetDriver->ClientConnections.Num());
+		for (const UNetConnection* Connection : NetDriver->ClientConnections)
+		{
+			if (Connection == nullptr) { continue; }
+
+			Phase.TotalBytesIn += Connection->InBytesPerSecond;
+			Phase.TotalBytesOut += Connection->OutBytesPerSecond;
+			Phase.NumConnectionSamples++;
+		}
+	}
+}
+
+void ANTGame_Benchmark::GetTotalMoveResults(uint32& OutGoodMoves, uint32& OutBadMoves) const
+{
+	OutGoodMoves = 0;
+	OutBadMoves = 0;
+
+	for (TActorIterator<ANTGame_Pawn> PawnItr(GetWorld()); PawnItr; ++PawnItr)
+	{
+		const UNTGame_MovementComponent* PawnMovement = PawnItr->GetPhysicsMovement();
+		if (PawnMovement == nullptr || !PawnMovement->HasPredictionData_Server()) { continue; }
+
+		const FNetworkPredictionData_Server_Physics* ServerData = static_cast<const FNetworkPredictionData_Server_Physics*>(PawnMovement->GetPredictionData_Server());
+		OutGoodMoves += ServerData->NumGoodMoves;
+		OutBadMoves += ServerData->NumBadMoves;
+	}
+}
+
+void ANTGame_Benchmark::GetTotalBotBits(uint64& OutBitsIn, uint64& OutBitsOut) const
+{
+	OutBitsIn = 0;
+	OutBitsOut = 0;
+
+	for (const ANTGame_Pawn* BotPawn : BotPawns)
+	{
+		const UNTGame_MovementComponent* BotMovement = BotPawn ? BotPawn->GetPhysicsMovement() : nullptr;
+		if (BotMovement == nullptr) { continue; }
+
+		const FNTGame_BandwidthStats& Stats = BotMovement->GetBandwidthStats();
+		for (uint8 RPCIdx = 0; RPCIdx < (uint8)ENTGame_MoveRPC::MAX; RPCIdx++)
+		{
+			if (RPCIdx == (uint8)ENTGame_MoveRPC::ServerMove)
+			{
+				OutBitsIn += Stats.RPCs[RPCIdx].TotalBits;
+			}
+			else
+			{
+				OutBitsOut += Stats.RPCs[RPCIdx].TotalBits;
+			}
+		}
+	}
+}
+
+void ANTGame_Benchmark::WriteResults() const
+{
+	FString Output;
+	TSharedRef<TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>::Create(&Output);
+
+	Writer->WriteObjectStart();
+	Writer->WriteValue(TEXT("map"), GetWorld()->GetMapName());
+	Writer->WriteValue(TEXT("phaseSeconds"), PhaseDuration);
+
+	Writer->WriteArrayStart(TEXT("phases"));
+	for (const FNTGame_BenchmarkPhase& Phase : Phases)
+	{
+		const float Samples = (float)FMath::Max(Phase.NumSamples, 1);
+		const float ConnectionSamples = (float)FMath::Max(Phase.NumConnectionSamples, 1);
+		const float Duration = FMath::Max(Phase.Duration, KINDA_SMALL_NUMBER);
+		const uint32 TotalMoves = Phase.GoodMoves + Phase.BadMoves;
+		const float PawnSeconds = (float)FMath::Max(Phase.NumPawns, 1) * Duration;
+
+		Writer->WriteObjectStart();
+		Writer->WriteValue(TEXT("pawns"), Phase.NumPawns);
+		Writer->WriteValue(TEXT("avgTickMs"), Phase.TotalTickMS / Samples);
+		Writer->WriteValue(TEXT("maxTickMs"), Phase.MaxTickMS);
+		Writer->WriteValue(TEXT("connections"), Phase.NumConnections);
+		Writer->WriteValue(TEXT("bytesInPerConnection"), Phase.TotalBytesIn / ConnectionSamples);
+		Writer->WriteValue(TEXT("bytesOutPerConnection"), Phase.TotalBytesOut / ConnectionSamples);
+		Writer->WriteValue(TEXT("botMoveBytesInPerPawn"), (float)Phase.BotBitsIn / 8.f / PawnSeconds);
+		Writer->WriteValue(TEXT("botMoveBytesOutPerPawn"), (float)Phase.BotBitsOut / 8.f / PawnSeconds);
+		Writer->WriteValue(TEXT("movesPerSecond"), (float)TotalMoves / Duration);
+		Writer->WriteValue(TEXT("correctionsPerSecond"), (float)Phase.BadMoves / Duration);
+		Writer->WriteValue(TEXT("correctionRate"), TotalMoves > 0 ? (float)Phase.BadMoves / (float)TotalMoves : 0.f);
+		Writer->WriteObjectEnd();
+	}
+	Writer->WriteArrayEnd();
+
+	Writer->WriteObjectEnd();
+	Writer->Close();
+
+	const FString OutputFilename = FString::Printf(TEXT("%sBenchmarks/NTBenchmark-%s.json"), *FPaths::GameSavedDir(), *FDateTime::Now().ToString());
+	if (FFileHelper::SaveStringToFile(Output, *OutputFilename))
+	{
+		UE_LOG(LogNTGame, Log, TEXT("NT Benchmark results written to %s"), *OutputFilename);
+	}
+	else
+	{
+		UE_LOG(LogNTGame, Error, TEXT("NT Benchmark unable to write results to %s"), *OutputFilename);
+	}
+}
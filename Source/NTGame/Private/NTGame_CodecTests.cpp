@@ -0,0 +1,215 @@
+// Copyright (C) James Baxter 2017. All Rights Reserved.
+// Round-trip tests and throughput measurement for the movement net serializers.
+
+#include "NTGame.h"
+#include "NTGame_MovementTypes.h"
+
+#include "AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+//////////////////////////
+///// Codec Settings /////
+//////////////////////////
+
+// One quantization step of an axis byte
+static const float AxisErrorBound = 2.f / 254.f + KINDA_SMALL_NUMBER;
+// SerializePackedVector<100, 30> rounds each component to 0.01, allow for float precision at the edge of the range
+static const float PackedVectorErrorBound = 0.006f;
+static const float PackedVectorRange = 20000.f;
+// Randomized round-trips per test
+static const int32 NumCodecIterations = 100000;
+// Stop reporting after this many failures, one bad quantizer would otherwise flood the log
+static const int32 MaxReportedFailures = 10;
+
+static FRepPlayerInput MakeRandomInput(FRandomStream& Stream)
+{
+	FRepPlayerInput Input = FRepPlayerInput();
+	Input.ForwardAxis = Stream.FRandRange(-1.f, 1.f);
+	Input.StrafeAxis = Stream.FRandRange(-1.f, 1.f);
+	Input.SteerAxis = Stream.FRandRange(-1.f, 1.f);
+	Input.PitchAxis = Stream.FRandRange(-1.f, 1.f);
+	Input.ControlFlags = (uint8)Stream.RandRange(0, 255);
+	return Input;
+}
+
+static FRepPawnMoveData MakeRandomMoveData(FRandomStream& Stream)
+{
+	FRepPawnMoveData MoveData = FRepPawnMoveData();
+	MoveData.Location = Stream.GetUnitVector() * Stream.FRandRange(0.f, PackedVectorRange);
+	MoveData.Rotation = FRotator(Stream.FRandRange(-90.f, 90.f), Stream.FRandRange(-180.f, 180.f), Stream.FRandRange(-180.f, 180.f)).Quaternion();
+	MoveData.LinearVelocity = Stream.GetUnitVector() * Stream.FRandRange(0.f, 10000.f);
+	MoveData.AngularVelocity = Stream.GetUnitVector() * Stream.FRandRange(0.f, 1000.f);
+	return MoveData;
+}
+
+/* Serialize a struct through a bit writer and read it back. Returns the number of bits written. */
+template<typename T>
+static int64 RoundTrip(const T& InValue, T& OutValue)
+{
+	T WriteCopy = InValue;
+	FBitWriter Writer(1024, true);
+	bool bSuccess = true;
+	WriteCopy.NetSerialize(Writer, nullptr, bSuccess);
+
+	FBitReader Reader(Writer.GetData(), Writer.GetNumBits());
+	OutValue.NetSerialize(Reader, nullptr, bSuccess);
+
+	return Writer.GetNumBits();
+}
+
+static bool IsVectorWithinBound(const FVector& A, const FVector& B, const float Bound)
+{
+	return FMath::Abs(A.X - B.X) <= Bound && FMath::Abs(A.Y - B.Y) <= Bound && FMath::Abs(A.Z - B.Z) <= Bound;
+}
+
+////////////////////////////
+///// Round-Trip Tests /////
+////////////////////////////
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNTGameInputCodecTest, "NTGame.Codec.PlayerInput", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FNTGameInputCodecTest::RunTest(const FString& Parameters)
+{
+	FRandomStream Stream(0x4E54);
+
+	// Zero input costs one flag bit per field
+	FRepPlayerInput ZeroOut = MakeRandomInput(Stream);
+	const int64 ZeroBits = RoundTrip(FRepPlayerInput(), ZeroOut);
+	TestEqual(TEXT("Zero input bits"), ZeroBits, (int64)5);
+	TestTrue(TEXT("Zero input decodes to zero"), ZeroOut == FRepPlayerInput());
+
+	// Full range extremes must be exact
+	const float Extremes[] = { -1.f, 0.f, 1.f };
+	for (const float Extreme : Extremes)
+	{
+		FRepPlayerInput In = FRepPlayerInput();
+		In.ForwardAxis = In.StrafeAxis = In.SteerAxis = In.PitchAxis = Extreme;
+
+		FRepPlayerInput Out = FRepPlayerInput();
+		RoundTrip(In, Out);
+		TestTrue(FString::Printf(TEXT("Extreme %f decoded to %s"), Extreme, *Out.ToString()), Out == In);
+	}
+
+	int32 NumFailures = 0;
+	for (int32 Idx = 0; Idx < NumCodecIterations; Idx++)
+	{
+		const FRepPlayerInput In = MakeRandomInput(Stream);
+		FRepPlayerInput Out = FRepPlayerInput();
+		RoundTrip(In, Out);
+
+		if (FMath::Abs(In.ForwardAxis - Out.ForwardAxis) > AxisErrorBound
+			|| FMath::Abs(In.StrafeAxis - Out.StrafeAxis) > AxisErrorBound
+			|| FMath::Abs(In.SteerAxis - Out.SteerAxis) > AxisErrorBound
+			|| FMath::Abs(In.PitchAxis - Out.PitchAxis) > AxisErrorBound
+			|| In.ControlFlags != Out.ControlFlags)
+		{
+			if (NumFailures < MaxReportedFailures)
+			{
+				AddError(FString::Printf(TEXT("Input %s decoded to %s"), *In.ToString(), *Out.ToString()));
+			}
+
+			NumFailures++;
+		}
+	}
+
+	TestEqual(TEXT("Random input failures"), NumFailures, 0);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNTGameMoveDataCodecTest, "NTGame.Codec.MoveData", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FNTGameMoveDataCodecTest::RunTest(const FString& Parameters)
+{
+	FRandomStream Stream(0x4E54);
+
+	int32 NumFailures = 0;
+	for (int32 Idx = 0; Idx < NumCodecIterations; Idx++)
+	{
+		const FRepPawnMoveData In = MakeRandomMoveData(Stream);
+		FRepPawnMoveData Out = FRepPawnMoveData();
+		RoundTrip(In, Out);
+
+		if (!IsVectorWithinBound(In.Location, Out.Location, PackedVectorErrorBound)
+			|| !IsVectorWithinBound(In.LinearVelocity, Out.LinearVelocity, PackedVectorErrorBound)
+			|| !IsVectorWithinBound(In.AngularVelocity, Out.AngularVelocity, PackedVectorErrorBound)
+			|| !In.Rotation.Equals(Out.Rotation, KINDA_SMALL_NUMBER))
+		{
+			if (NumFailures < MaxReportedFailures)
+			{
+				AddError(FString::Printf(TEXT("Move Data: Loc %s -> %s, Vel %s -> %s, AngVel %s -> %s"),
+					*In.Location.ToString(), *Out.Location.ToString(),
+					*In.LinearVelocity.ToString(), *Out.LinearVelocity.ToString(),
+					*In.AngularVelocity.ToString(), *Out.AngularVelocity.ToString()));
+			}
+
+			NumFailures++;
+		}
+	}
+
+	TestEqual(TEXT("Random move data failures"), NumFailures, 0);
+	return true;
+}
+
+////////////////////////////
+///// Codec Throughput /////
+////////////////////////////
+
+/* Encode every struct into one stream, then decode them all back. Logs millions of structs per second for each. */
+template<typename T>
+static void MeasureThroughput(FAutomationTestBase& InTest, const TCHAR* InName, const TArray<T>& InValues)
+{
+	TArray<T> Values = InValues;
+	TArray<T> Decoded;
+	Decoded.SetNum(Values.Num());
+
+	FBitWriter Writer(Values.Num() * 512, true);
+	bool bSuccess = true;
+
+	const double EncodeStart = FPlatformTime::Seconds();
+	for (T& Value : Values)
+	{
+		Value.NetSerialize(Writer, nullptr, bSuccess);
+	}
+	const double EncodeTime = FPlatformTime::Seconds() - EncodeStart;
+
+	FBitReader Reader(Writer.GetData(), Writer.GetNumBits());
+
+	const double DecodeStart = FPlatformTime::Seconds();
+	for (T& Value : Decoded)
+	{
+		Value.NetSerialize(Reader, nullptr, bSuccess);
+	}
+	const double DecodeTime = FPlatformTime::Seconds() - DecodeStart;
+
+	InTest.AddInfo(FString::Printf(TEXT("%s: %d structs, %.2f bits avg, Encode %.2f M/s, Decode %.2f M/s"),
+		InName, Values.Num(),
+		(float)Writer.GetNumBits() / (float)Values.Num(),
+		Values.Num() / FMath::Max(EncodeTime, SMALL_NUMBER) / 1000000.0,
+		Values.Num() / FMath::Max(DecodeTime, SMALL_NUMBER) / 1000000.0));
+}
+
+/* Timing only, so it lives under the performance filter and stays out of regular test runs */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNTGameCodecThroughputTest, "NTGame.Codec.Throughput", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FNTGameCodecThroughputTest::RunTest(const FString& Parameters)
+{
+	FRandomStream Stream(0x4E54);
+
+	TArray<FRepPlayerInput> Inputs;
+	TArray<FRepPawnMoveData> MoveData;
+	Inputs.Reserve(NumCodecIterations);
+	MoveData.Reserve(NumCodecIterations);
+
+	for (int32 Idx = 0; Idx < NumCodecIterations; Idx++)
+	{
+		Inputs.Add(MakeRandomInput(Stream));
+		MoveData.Add(MakeRandomMoveData(Stream));
+	}
+
+	MeasureThroughput(*this, TEXT("FRepPlayerInput"), Inputs);
+	MeasureThroughput(*this, TEXT("FRepPawnMoveData"), MoveData);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
\ No newline at end of file
@@ -0,0 +1,185 @@
+// Copyright (C) James Baxter 2017. All Rights Reserved.
+
+#include "NTGame.h"
+#include "NTGame_CorrectionHeatmap.h"
+
+/////////////////////////////
+///// Console Variables /////
+/////////////////////////////
+
+static TAutoConsoleVariable<int32> CVarNTHeatmapEnable(
+	TEXT("NT.HeatmapEnable"),
+	0,
+	TEXT("Record the location, error and contact of every server correction into a spatial grid. Use NT.Heatmap to export or draw.\n")
+	TEXT("0: Disabled, 1: Enabled"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarNTHeatmapCellSize(
+	TEXT("NT.HeatmapCellSize"),
+	500.f,
+	TEXT("Size of each correction heatmap cell in world units. Applied on the next reset."),
+	ECVF_Default);
+
+////////////////////////
+///// Heatmap Cell /////
+////////////////////////
+
+FName FNTGame_HeatmapCell::GetWorstContact() const
+{
+	FName Worst = NAME_None;
+	uint32 WorstCount = 0;
+
+	for (const TPair<FName, uint32>& Contact : ContactCounts)
+	{
+		if (Contact.Value > WorstCount)
+		{
+			Worst = Contact.Key;
+			WorstCount = Contact.Value;
+		}
+	}
+
+	return Worst;
+}
+
+///////////////////
+///// Heatmap /////
+///////////////////
+
+FNTGame_CorrectionHeatmap& FNTGame_CorrectionHeatmap::Get()
+{
+	static FNTGame_CorrectionHeatmap Heatmap;
+	return Heatmap;
+}
+
+bool FNTGame_CorrectionHeatmap::IsEnabled()
+{
+	return CVarNTHeatmapEnable.GetValueOnGameThread() > 0;
+}
+
+FNTGame_CorrectionHeatmap::FNTGame_CorrectionHeatmap()
+	: CellSize(0.f)
+{}
+
+void FNTGame_CorrectionHeatmap::RecordCorrection(const FVector& InLocation, const float InError, const UPrimitiveComponent* InContact)
+{
+	if (CellSize <= 0.f)
+	{
+		CellSize = FMath::Max(CVarNTHeatmapCellSize.GetValueOnGameThread(), 1.f);
+	}
+
+	FNTGame_HeatmapCell& Cell = Cells.FindOrAdd(GetCellKey(InLocation));
+	Cell.NumCorrections++;
+	Cell.TotalError += InError;
+	Cell.MaxError = FMath::Max(Cell.MaxError, InError);
+
+	if (InContact != nullptr)
+	{
+		Cell.NumInContact++;
+
+		// Prefer the mesh asset, so every instance of a problem mesh groups together
+		const UStaticMeshComponent* MeshComp = Cast<UStaticMeshComponent>(InContact);
+		const FName ContactName = (MeshComp && MeshComp->GetStaticMesh()) ? MeshComp->GetStaticMesh()->GetFName() : InContact->GetFName();
+		Cell.ContactCounts.FindOrAdd(ContactName)++;
+	}
+}
+
+void FNTGame_CorrectionHeatmap::Reset()
+{
+	Cells.Empty();
+	CellSize = 0.f;
+}
+
+FIntVector FNTGame_CorrectionHeatmap::GetCellKey(const FVector& InLocation) const
+{
+	return FIntVector(
+		FMath::FloorToInt(InLocation.X / CellSize),
+		FMath::FloorToInt(InLocation.Y / CellSize),
+		FMath::FloorToInt(InLocation.Z / CellSize));
+}
+
+FVector FNTGame_CorrectionHeatmap::GetCellCentre(const FIntVector& InKey) const
+{
+	return (FVector(InKey.X, InKey.Y, InKey.Z) + FVector(0.5f)) * CellSize;
+}
+
+bool FNTGame_CorrectionHeatmap::ExportCSV(const FString& InFilename) const
+{
+	FString Output = TEXT("CellX,CellY,CellZ,CentreX,CentreY,CentreZ,Corrections,InContact,AvgError,MaxError,WorstContact\n");
+
+	for (const TPair<FIntVector, FNTGame_HeatmapCell>& CellPair : Cells)
+	{
+		const FNTGame_HeatmapCell& Cell = CellPair.Value;
+		const FVector Centre = GetCellCentre(CellPair.Key);
+
+		Output += FString::Printf(TEXT("%d,%d,%d,%f,%f,%f,%u,%u,%f,%f,%s\n"),
+			CellPair.Key.X, CellPair.Key.Y, CellPair.Key.Z,
+			Centre.X, Centre.Y, Centre.Z,
+			Cell.NumCorrections,
+			Cell.NumInContact,
+			Cell.TotalError / (float)FMath::Max(Cell.NumCorrections, 1u),
+			Cell.MaxError,
+			*Cell.GetWorstContact().ToString());
+	}
+
+	return FFileHelper::SaveStringToFile(Output, *InFilename);
+}
+
+void FNTGame_CorrectionHeatmap::Draw(UWorld* InWorld, const float InDuration) const
+{
+	if (InWorld == nullptr) { return; }
+
+	uint32 MaxCorrections = 1;
+	for (const TPair<FIntVector, FNTGame_HeatmapCell>& CellPair : Cells)
+	{
+		MaxCorrections = FMath::Max(MaxCorrections, CellPair.Value.NumCorrections);
+	}
+
+	const FVector Extent = FVector(CellSize * 0.5f);
+	for (const TPair<FIntVector, FNTGame_HeatmapCell>& CellPair : Cells)
+	{
+		const FNTGame_HeatmapCell& Cell = CellPair.Value;
+		const float Heat = (float)Cell.NumCorrections / (float)MaxCorrections;
+		const FColor HeatColour = FLinearColor::LerpUsingHSV(FLinearColor::Green, FLinearColor::Red, Heat).ToFColor(true);
+		const FVector Centre = GetCellCentre(CellPair.Key);
+
+		DrawDebugSolidBox(InWorld, Centre, Extent * 0.95f, FColor(HeatColour.R, HeatColour.G, HeatColour.B, 64), false, InDuration);
+		DrawDebugString(InWorld, Centre, FString::Printf(TEXT("%u (%s)"), Cell.NumCorrections, *Cell.GetWorstContact().ToString()), nullptr, HeatColour, InDuration);
+	}
+}
+
+///////////////////////////
+///// Console Command /////
+///////////////////////////
+
+static void NTHeatmap(const TArray<FString>& Args, UWorld* World)
+{
+	FNTGame_CorrectionHeatmap& Heatmap = FNTGame_CorrectionHeatmap::Get();
+	const FString Mode = Args.Num() > 0 ? Args[0] : FString(TEXT("dump"));
+
+	if (Mode == TEXT("reset"))
+	{
+		Heatmap.Reset();
+	}
+	else if (Mode == TEXT("draw"))
+	{
+		const float Duration = Args.Num() > 1 ? FCString::Atof(*Args[1]) : 10.f;
+		Heatmap.Draw(World, Duration);
+	}
+	else
+	{
+		const FString OutputFilename = FString::Printf(TEXT("%sTelemetry/NTHeatmap-%s.csv"), *FPaths::GameSavedDir(), *FDateTime::Now().ToString());
+		if (Heatmap.ExportCSV(OutputFilename))
+		{
+			UE_LOG(LogNTGameMovement, Log, TEXT("Correction heatmap (%d cells) written to %s"), Heatmap.GetNumCells(), *OutputFilename);
+		}
+		else
+		{
+			UE_LOG(LogNTGameMovement, Error, TEXT("Unable to write correction heatmap to %s"), *OutputFilename);
+		}
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs NTHeatmapCommand(
+	TEXT("NT.Heatmap"),
+	TEXT("Export, draw or reset the server correction heatmap. NT.Heatmap [dump | draw <Seconds> | reset]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&NTHeatmap));
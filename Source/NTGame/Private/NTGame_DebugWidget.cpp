@@ -8,24 +8,43 @@
 
 // Components
 #include "TextBlock.h"
+#include "Blueprint/WidgetBlueprintLibrary.h"
 
 #define LOCTEXT_NAMESPACE "DebugWidgetNS"
 
 UNTGame_DebugWidget::UNTGame_DebugWidget(const FObjectInitializer& OI)
 	: Super(OI)
-{}
+{
+	SampleRate = 10.f;
+	SparklineOrigin = FVector2D(16.f, 320.f);
+	SparklineSize = FVector2D(192.f, 32.f);
+	SparklineSpacing = 8.f;
+
+	for (int32 Idx = 0; Idx < ARRAY_COUNT(DisplayedPacketSettings); Idx++)
+	{
+		DisplayedPacketSettings[Idx] = INDEX_NONE;
+	}
+}
 
 void UNTGame_DebugWidget::NativeTick(const FGeometry& MyGeometry, float InDeltaTime)
 {
 	Super::NativeTick(MyGeometry, InDeltaTime);
 
-	UpdateDynamicData();
+	const ANTGame_Pawn* OwningNTPawn = Cast<ANTGame_Pawn>(GetOwningPlayerPawn());
+	const UNTGame_MovementComponent* OwningNTMovement = OwningNTPawn ? OwningNTPawn->GetPhysicsMovement() : nullptr;
+
+	Sampler.SampleInterval = 1.f / FMath::Max(SampleRate, 1.f);
+	if (Sampler.Tick(InDeltaTime, OwningNTMovement, GetOwningPlayer()->GetNetConnection()))
+	{
+		UpdateDynamicData();
+		UpdateSparklines();
+	}
 }
 
 void UNTGame_DebugWidget::UpdateDynamicData()
 {
 	const bool bIsServer = GetOwningPlayer()->GetNetMode() < NM_Client ? true : false;
-	TitleText->SetText(bIsServer ? FText::FromString(TEXT("Server")) : FText::FromString(TEXT("Client")));
+	SetTextIfChanged(TitleText, bIsServer ? TEXT("Server") : TEXT("Client"));
 
 	const ANTGame_Pawn* OwningNTPawn = Cast<ANTGame_Pawn>(GetOwningPlayerPawn());
 	if (OwningNTPawn)
@@ -33,47 +52,118 @@ void UNTGame_DebugWidget::UpdateDynamicData()
 		const UNTGame_MovementComponent* OwningNTMovement = OwningNTPawn->GetPhysicsMovement();
 		ASSERTV(OwningNTMovement != nullptr, TEXT("Invalid Pawn Movement"))
 
-		InputText->SetText(FText::FromString(OwningNTMovement->GetLastControlInput().ToString()));
+		SetTextIfChanged(InputText, OwningNTMovement->GetLastControlInput().ToString());
 
-		VelocText->SetText(FText::FromString(TEXT("Veloc: ") + OwningNTMovement->Velocity.ToString()));
-		OmegaText->SetText(FText::FromString(TEXT("Omega: ") + OwningNTMovement->Omega.ToString()));
-		AccelText->SetText(FText::FromString(TEXT("Accel: ") + OwningNTMovement->Accel.ToString()));
-		AlphaText->SetText(FText::FromString(TEXT("Alpha: ") + OwningNTMovement->Alpha.ToString()));
+		// Magnitudes only, the full vectors change every frame and are unreadable at this rate
+		SetTextIfChanged(VelocText, FString::Printf(TEXT("Veloc: %.0f"), OwningNTMovement->Velocity.Size()));
+		SetTextIfChanged(OmegaText, FString::Printf(TEXT("Omega: %.2f"), OwningNTMovement->Omega.Size()));
+		SetTextIfChanged(AccelText, FString::Printf(TEXT("Accel: %.0f"), OwningNTMovement->Accel.Size()));
+		SetTextIfChanged(AlphaText, FString::Printf(TEXT("Alpha: %.2f"), OwningNTMovement->Alpha.Size()));
 	}
 
+	SetTextIfChanged(RTTText, FString::Printf(TEXT("RTT: %.0fms"), Sampler.GetChannel(ENTGame_TelemetryChannel::RTT).GetLatest()));
+	SetTextIfChanged(ReplayText, FString::Printf(TEXT("Replay: %.0f moves"), Sampler.GetChannel(ENTGame_TelemetryChannel::ReplayLength).GetLatest()));
+	SetTextIfChanged(CorrectionText, FString::Printf(TEXT("Corrections: %.1f/s"), Sampler.GetChannel(ENTGame_TelemetryChannel::CorrectionRate).GetLatest()));
+	SetTextIfChanged(BandwidthText, FString::Printf(TEXT("Bandwidth: %.0f B/s"), Sampler.GetChannel(ENTGame_TelemetryChannel::BytesPerSecond).GetLatest()));
+	SetTextIfChanged(MovementTimeText, FString::Printf(TEXT("Movement: %.3fms"), Sampler.GetChannel(ENTGame_TelemetryChannel::MovementMS).GetLatest()));
+
 	// If client, set lag text
 	if (!bIsServer)
 	{
-		const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
-		ASSERTV(NetDriver != nullptr, TEXT("Invalid Net Driver"));
+		UpdatePacketSimulationData();
+	}
+}
+
+void UNTGame_DebugWidget::UpdatePacketSimulationData()
+{
+	const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	ASSERTV(NetDriver != nullptr, TEXT("Invalid Net Driver"));
 		
-		const int32 BaseLag = NetDriver->PacketSimulationSettings.PktLag;
-		const int32 VariLag = NetDriver->PacketSimulationSettings.PktLagVariance;
-		const int32 PakLoss = NetDriver->PacketSimulationSettings.PktLoss;
-		const int32 PakDupe = NetDriver->PacketSimulationSettings.PktDup;
-		const int32 PakOrdr = NetDriver->PacketSimulationSettings.PktOrder;
-
-		// Build Strings
-		const FText LatencyVar = FText::Format(LOCTEXT("LatencyVar", "~+ {0}ms"), FText::AsNumber(VariLag));
-		const FText LatencyText = FText::Format(LOCTEXT("Latency", "Latency: {0}ms {1}"), FText::AsNumber(BaseLag), VariLag > 0 ? LatencyVar : FText());
-
-		const FText LossText = FText::Format(LOCTEXT("Loss", "Packet Loss: {0}"), FText::AsPercent((float)PakLoss / 100.f));
-		const FText DupeText = FText::Format(LOCTEXT("Dupe", "Packet Dupe: {0}"), FText::AsPercent((float)PakDupe / 100.f));
-		const FText OrdrText = FText::Format(LOCTEXT("Order", "Packet Order: {0}"), PakOrdr > 0 ? FText::FromString(TEXT("ON")) : FText::FromString(TEXT("OFF")));
-
-		const FLinearColor LagColour = FLinearColor::LerpUsingHSV(FLinearColor::Green, FLinearColor::Red, FMath::GetMappedRangeValueClamped(FVector2D(0.f, 150.f), FVector2D(0.f, 1.f), (float)BaseLag));
-		const FLinearColor LossColour = FLinearColor::LerpUsingHSV(FLinearColor::Green, FLinearColor::Red, FMath::GetMappedRangeValueClamped(FVector2D(0.f, 100.f), FVector2D(0.f, 1.f), (float)PakLoss));
-		const FLinearColor DupeColour = FLinearColor::LerpUsingHSV(FLinearColor::Green, FLinearColor::Red, FMath::GetMappedRangeValueClamped(FVector2D(0.f, 100.f), FVector2D(0.f, 1.f), (float)PakDupe));
-
-		PacketLag->SetText(LatencyText);
-		PacketLoss->SetText(LossText);
-		PacketDupe->SetText(DupeText);
-		PacketOrder->SetText(OrdrText);
-
-		PacketLag->SetColorAndOpacity(FSlateColor(LagColour));
-		PacketLoss->SetColorAndOpacity(FSlateColor(LossColour));
-		PacketDupe->SetColorAndOpacity(FSlateColor(DupeColour));
-		PacketOrder->SetColorAndOpacity(PakOrdr > 0 ? FLinearColor::Red : FLinearColor::Gray);
+	const int32 BaseLag = NetDriver->PacketSimulationSettings.PktLag;
+	const int32 VariLag = NetDriver->PacketSimulationSettings.PktLagVariance;
+	const int32 PakLoss = NetDriver->PacketSimulationSettings.PktLoss;
+	const int32 PakDupe = NetDriver->PacketSimulationSettings.PktDup;
+	const int32 PakOrdr = NetDriver->PacketSimulationSettings.PktOrder;
+
+	// Settings rarely change, only rebuild text when they do
+	const int32 Settings[] = { BaseLag, VariLag, PakLoss, PakDupe, PakOrdr };
+	static_assert(ARRAY_COUNT(Settings) == ARRAY_COUNT(DisplayedPacketSettings), "Packet setting count mismatch");
+	if (FMemory::Memcmp(Settings, DisplayedPacketSettings, sizeof(Settings)) == 0) { return; }
+	FMemory::Memcpy(DisplayedPacketSettings, Settings, sizeof(Settings));
+
+	// Build Strings
+	const FText LatencyVar = FText::Format(LOCTEXT("LatencyVar", "~+ {0}ms"), FText::AsNumber(VariLag));
+	const FText LatencyText = FText::Format(LOCTEXT("Latency", "Latency: {0}ms {1}"), FText::AsNumber(BaseLag), VariLag > 0 ? LatencyVar : FText());
+
+	const FText LossText = FText::Format(LOCTEXT("Loss", "Packet Loss: {0}"), FText::AsPercent((float)PakLoss / 100.f));
+	const FText DupeText = FText::Format(LOCTEXT("Dupe", "Packet Dupe: {0}"), FText::AsPercent((float)PakDupe / 100.f));
+	const FText OrdrText = FText::Format(LOCTEXT("Order", "Packet Order: {0}"), PakOrdr > 0 ? FText::FromString(TEXT("ON")) : FText::FromString(TEXT("OFF")));
+
+	const FLinearColor LagColour = FLinearColor::LerpUsingHSV(FLinearColor::Green, FLinearColor::Red, FMath::GetMappedRangeValueClamped(FVector2D(0.f, 150.f), FVector2D(0.f, 1.f), (float)BaseLag));
+	const FLinearColor LossColour = FLinearColor::LerpUsingHSV(FLinearColor::Green, FLinearColor::Red, FMath::GetMappedRangeValueClamped(FVector2D(0.f, 100.f), FVector2D(0.f, 1.f), (float)PakLoss));
+	const FLinearColor DupeColour = FLinearColor::LerpUsingHSV(FLinearColor::Green, FLinearColor::Red, FMath::GetMappedRangeValueClamped(FVector2D(0.f, 100.f), FVector2D(0.f, 1.f), (float)PakDupe));
+
+	PacketLag->SetText(LatencyText);
+	PacketLoss->SetText(LossText);
+	PacketDupe->SetText(DupeText);
+	PacketOrder->SetText(OrdrText);
+
+	PacketLag->SetColorAndOpacity(FSlateColor(LagColour));
+	PacketLoss->SetColorAndOpacity(FSlateColor(LossColour));
+	PacketDupe->SetColorAndOpacity(FSlateColor(DupeColour));
+	PacketOrder->SetColorAndOpacity(PakOrdr > 0 ? FLinearColor::Red : FLinearColor::Gray);
+}
+
+void UNTGame_DebugWidget::SetTextIfChanged(UTextBlock* InTextBlock, const FString& InString)
+{
+	if (InTextBlock == nullptr) { return; }
+
+	FString& Displayed = DisplayedStrings.FindOrAdd(InTextBlock);
+	if (Displayed.Equals(InString, ESearchCase::CaseSensitive)) { return; }
+
+	Displayed = InString;
+	InTextBlock->SetText(FText::FromString(InString));
+}
+
+//////////////////////
+///// Sparklines /////
+//////////////////////
+
+void UNTGame_DebugWidget::UpdateSparklines()
+{
+	for (int32 ChannelIdx = 0; ChannelIdx < (int32)ENTGame_TelemetryChannel::MAX; ChannelIdx++)
+	{
+		const FNTGame_TelemetryChannel& Channel = Sampler.GetChannel((ENTGame_TelemetryChannel)ChannelIdx);
+		TArray<FVector2D>& Points = SparklinePoints[ChannelIdx];
+		Points.Reset(Channel.Num());
+
+		// Each line is scaled to its own peak
+		const float Scale = 1.f / FMath::Max(Channel.GetMax(), KINDA_SMALL_NUMBER);
+		const float StepX = SparklineSize.X / (float)(FNTGame_TelemetryChannel::Capacity - 1);
+		const FVector2D Origin = SparklineOrigin + FVector2D(0.f, ChannelIdx * (SparklineSize.Y + SparklineSpacing));
+
+		for (int32 Idx = 0; Idx < Channel.Num(); Idx++)
+		{
+			Points.Add(Origin + FVector2D(Idx * StepX, SparklineSize.Y * (1.f - Channel.GetSample(Idx) * Scale)));
+		}
+
+		SparklineLabels[ChannelIdx] = FString::Printf(TEXT("%s %.1f (max %.1f)"), FNTGame_TelemetrySampler::GetChannelName((ENTGame_TelemetryChannel)ChannelIdx), Channel.GetLatest(), Channel.GetMax());
+	}
+}
+
+void UNTGame_DebugWidget::NativePaint(FPaintContext& InContext) const
+{
+	Super::NativePaint(InContext);
+
+	for (int32 ChannelIdx = 0; ChannelIdx < (int32)ENTGame_TelemetryChannel::MAX; ChannelIdx++)
+	{
+		const TArray<FVector2D>& Points = SparklinePoints[ChannelIdx];
+		if (Points.Num() < 2) { continue; }
+
+		const FVector2D LabelPos = SparklineOrigin + FVector2D(SparklineSize.X + 4.f, ChannelIdx * (SparklineSize.Y + SparklineSpacing));
+
+		UWidgetBlueprintLibrary::DrawLines(InContext, Points, FLinearColor::Yellow, true);
+		UWidgetBlueprintLibrary::DrawText(InContext, SparklineLabels[ChannelIdx], LabelPos, FLinearColor::White);
 	}
 }
 
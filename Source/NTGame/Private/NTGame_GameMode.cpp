@@ -14,6 +14,33 @@ ANTGame_GameMode::ANTGame_GameMode(const FObjectInitializer& OI)
 	PlayerControllerClass = ANTGame_PlayerController::StaticClass();
 	HUDClass = ANTGame_DebugHUD::StaticClass();
 	DefaultPawnClass = ANTGame_Pawn::StaticClass();
+
+	// Pooling
+	PooledPawnsPerClass = 2;
+}
+
+void ANTGame_GameMode::BeginPlay()
+{
+	Super::BeginPlay();
+
+	FActorSpawnParameters SpawnInfo;
+	SpawnInfo.ObjectFlags |= RF_Transient;
+	SpawnInfo.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	for (const TSubclassOf<ANTGame_Pawn>& PawnClass : AvailablePawns)
+	{
+		if (PawnClass == nullptr) { continue; }
+
+		for (int32 Idx = 0; Idx < PooledPawnsPerClass; Idx++)
+		{
+			ANTGame_Pawn* NewPawn = GetWorld()->SpawnActor<ANTGame_Pawn>(PawnClass, FVector::ZeroVector, FRotator::ZeroRotator, SpawnInfo);
+			if (NewPawn)
+			{
+				NewPawn->DeactivateToPool();
+				PooledPawns.Add(NewPawn);
+			}
+		}
+	}
 }
 
 /////////////////////////
@@ -27,11 +54,17 @@ APawn* ANTGame_GameMode::SpawnDefaultPawnFor_Implementation(AController* NewPlay
 	StartRotation.Yaw = StartSpot->GetActorRotation().Yaw;
 	FVector StartLocation = StartSpot->GetActorLocation();
 
+	UClass* PawnClass = GetDefaultPawnClassForController(NewPlayer);
+	APawn* PooledPawn = AcquirePooledPawn(PawnClass, StartLocation, StartRotation);
+	if (PooledPawn)
+	{
+		return PooledPawn;
+	}
+
 	FActorSpawnParameters SpawnInfo;
 	SpawnInfo.Instigator = Instigator;
 	SpawnInfo.ObjectFlags |= RF_Transient;	// We never want to save default player pawns into a map
 	SpawnInfo.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
-	UClass* PawnClass = GetDefaultPawnClassForController(NewPlayer);
 	APawn* ResultPawn = GetWorld()->SpawnActor<APawn>(PawnClass, StartLocation, StartRotation, SpawnInfo);
 	return ResultPawn;
 }
@@ -53,4 +86,65 @@ UClass* ANTGame_GameMode::GetDefaultPawnClassForController_Implementation(AContr
 	}
 
 	return DefaultPawnClass;
+}
+
+///////////////////
+///// Pooling /////
+///////////////////
+
+ANTGame_Pawn* ANTGame_GameMode::AcquirePooledPawn(UClass* InPawnClass, const FVector& InLocation, const FRotator& InRotation)
+{
+	for (int32 Idx = PooledPawns.Num() - 1; Idx >= 0; Idx--)
+	{
+		ANTGame_Pawn* PooledPawn = PooledPawns[Idx];
+		if (PooledPawn == nullptr || PooledPawn->IsPendingKill())
+		{
+			PooledPawns.RemoveAtSwap(Idx, 1, false);
+		}
+		else if (PooledPawn->GetClass() == InPawnClass)
+		{
+			PooledPawns.RemoveAtSwap(Idx, 1, false);
+			PooledPawn->ActivateFromPool(InLocation, InRotation);
+			return PooledPawn;
+		}
+	}
+
+	return nullptr;
+}
+
+void ANTGame_GameMode::ReleasePawn(APawn* InPawn)
+{
+	if (InPawn == nullptr) { return; }
+
+	ANTGame_Pawn* NTPawn = Cast<ANTGame_Pawn>(InPawn);
+	if (NTPawn == nullptr || NTPawn->IsPooled() || PooledPawnsPerClass <= 0)
+	{
+		// Will unpossess and properly detach from pawn
+		InPawn->Destroy();
+		return;
+	}
+
+	// Only keep as many as we pre-spawn, anything past that is churn
+	int32 NumPooledOfClass = 0;
+	for (const ANTGame_Pawn* PooledPawn : PooledPawns)
+	{
+		if (PooledPawn && PooledPawn->GetClass() == NTPawn->GetClass())
+		{
+			NumPooledOfClass++;
+		}
+	}
+
+	if (NumPooledOfClass >= PooledPawnsPerClass)
+	{
+		InPawn->Destroy();
+		return;
+	}
+
+	if (InPawn->Controller)
+	{
+		InPawn->Controller->UnPossess();
+	}
+
+	NTPawn->DeactivateToPool();
+	PooledPawns.Add(NTPawn);
 }
\ No newline at end of file
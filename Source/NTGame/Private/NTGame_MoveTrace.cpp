@@ -0,0 +1,208 @@
+// Copyright (C) James Baxter 2017. All Rights Reserved.
+
+#include "NTGame.h"
+#include "NTGame_MoveTrace.h"
+#include "NTGame_MovementComponent.h"
+
+///////////////////
+///// Statics /////
+///////////////////
+
+const uint32 FNTGame_MoveTraceHeader::TraceMagic = 0x5254544E;	// 'NTTR'
+const int32 FNTGame_MoveTraceHeader::TraceVersion = 1;
+
+/////////////////////////
+///// Serialization /////
+/////////////////////////
+
+void SerializeTraceInput(FArchive& Ar, FRepPlayerInput& Input)
+{
+	Ar << Input.ForwardAxis;
+	Ar << Input.StrafeAxis;
+	Ar << Input.SteerAxis;
+	Ar << Input.PitchAxis;
+	Ar << Input.ControlFlags;
+}
+
+void SerializeTraceMoveData(FArchive& Ar, FRepPawnMoveData& MoveData)
+{
+	Ar << MoveData.Location;
+	Ar << MoveData.Rotation;
+	Ar << MoveData.LinearVelocity;
+	Ar << MoveData.AngularVelocity;
+}
+
+FArchive& operator<<(FArchive& Ar, FNTGame_MoveTraceRecord& Record)
+{
+	uint8 TypeByte = (uint8)Record.Type;
+	Ar << TypeByte;
+	Record.Type = (ENTGame_TraceRecord)TypeByte;
+
+	switch (Record.Type)
+	{
+		case ENTGame_TraceRecord::ClientMove:
+			Ar << Record.TimeStamp;
+			Ar << Record.DeltaTime;
+			SerializeTraceInput(Ar, Record.Input);
+			SerializeTraceMoveData(Ar, Record.MoveData);
+			break;
+		case ENTGame_TraceRecord::ServerStep:
+			Ar << Record.DeltaTime;
+			SerializeTraceMoveData(Ar, Record.MoveData);
+			break;
+		default:
+			Ar.SetError();
+			break;
+	}
+
+	return Ar;
+}
+
+FArchive& operator<<(FArchive& Ar, FNTGame_MoveTraceHeader& Header)
+{
+	Ar << Header.Magic;
+	Ar << Header.Version;
+	Ar << Header.MapName;
+	Ar << Header.PawnClassPath;
+	SerializeTraceMoveData(Ar, Header.InitialState);
+
+	return Ar;
+}
+
+////////////////////
+///// Recorder /////
+////////////////////
+
+FNTGame_MoveTraceRecorder::FNTGame_MoveTraceRecorder()
+	: Writer(nullptr)
+	, NumRecords(0)
+{}
+
+FNTGame_MoveTraceRecorder::~FNTGame_MoveTraceRecorder()
+{
+	Stop();
+}
+
+bool FNTGame_MoveTraceRecorder::Start(const FString& InFilename, FNTGame_MoveTraceHeader& InHeader)
+{
+	Stop();
+
+	Writer = IFileManager::Get().CreateFileWriter(*InFilename);
+	if (Writer == nullptr)
+	{
+		UE_LOG(LogNTGameMovement, Error, TEXT("Unable to open move trace %s"), *InFilename);
+		return false;
+	}
+
+	Filename = InFilename;
+	NumRecords = 0;
+
+	*Writer << InHeader;
+	return true;
+}
+
+void FNTGame_MoveTraceRecorder::Stop()
+{
+	if (Writer == nullptr) { return; }
+
+	Writer->Close();
+	delete Writer;
+	Writer = nullptr;
+
+	UE_LOG(LogNTGameMovement, Log, TEXT("Move trace %s finished with %d records"), *Filename, NumRecords);
+}
+
+void FNTGame_MoveTraceRecorder::RecordClientMove(const float InTimeStamp, const float InAccelDelta, const FRepPlayerInput& InInput, const FRepPawnMoveData& InClientEndData)
+{
+	if (Writer == nullptr) { return; }
+
+	FNTGame_MoveTraceRecord Record = FNTGame_MoveTraceRecord();
+	Record.Type = ENTGame_TraceRecord::ClientMove;
+	Record.TimeStamp = InTimeStamp;
+	Record.DeltaTime = InAccelDelta;
+	Record.Input = InInput;
+	Record.MoveData = InClientEndData;
+
+	*Writer << Record;
+	NumRecords++;
+}
+
+void FNTGame_MoveTraceRecorder::RecordServerStep(const float InDeltaTime, const FRepPawnMoveData& InServerEndData)
+{
+	if (Writer == nullptr) { return; }
+
+	FNTGame_MoveTraceRecord Record = FNTGame_MoveTraceRecord();
+	Record.Type = ENTGame_TraceRecord::ServerStep;
+	Record.DeltaTime = InDeltaTime;
+	Record.MoveData = InServerEndData;
+
+	*Writer << Record;
+	NumRecords++;
+}
+
+/////////////////
+///// Trace /////
+/////////////////
+
+bool FNTGame_MoveTrace::Load(const FString& InFilename)
+{
+	FArchive* Reader = IFileManager::Get().CreateFileReader(*InFilename);
+	if (Reader == nullptr)
+	{
+		UE_LOG(LogNTGameMovement, Error, TEXT("Unable to open move trace %s"), *InFilename);
+		return false;
+	}
+
+	*Reader << Header;
+
+	bool bSuccess = Header.IsValid() && !Reader->IsError();
+	while (bSuccess && !Reader->AtEnd())
+	{
+		FNTGame_MoveTraceRecord& NewRecord = Records[Records.AddDefaulted()];
+		*Reader << NewRecord;
+		bSuccess = !Reader->IsError();
+	}
+
+	Reader->Close();
+	delete Reader;
+
+	UE_CLOG(!bSuccess, LogNTGameMovement, Error, TEXT("Move trace %s is invalid or corrupt"), *InFilename);
+	return bSuccess;
+}
+
+///////////////////////////
+///// Console Command /////
+///////////////////////////
+
+static void RecordNTTraces(const TArray<FString>& Args, UWorld* World)
+{
+	if (World == nullptr || World->GetNetMode() == NM_Client)
+	{
+		UE_LOG(LogNTGameMovement, Warning, TEXT("NT.RecordTraces must be run on a server"));
+		return;
+	}
+
+	const bool bStart = Args.Num() == 0 || Args[0] != TEXT("stop");
+	const FString TraceDir = FString::Printf(TEXT("%sTraces/%s/"), *FPaths::GameSavedDir(), *FDateTime::Now().ToString());
+
+	for (TObjectIterator<UNTGame_MovementComponent> CompItr; CompItr; ++CompItr)
+	{
+		UNTGame_MovementComponent* MoveComp = *CompItr;
+		if (MoveComp == nullptr || MoveComp->GetWorld() != World || MoveComp->GetOwner() == nullptr) { continue; }
+		if (MoveComp->GetOwner()->GetRemoteRole() != ROLE_AutonomousProxy) { continue; }
+
+		if (bStart)
+		{
+			MoveComp->StartMoveTrace(TraceDir + MoveComp->GetOwner()->GetName() + TEXT(".nttrace"));
+		}
+		else
+		{
+			MoveComp->StopMoveTrace();
+		}
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs NTRecordTracesCommand(
+	TEXT("NT.RecordTraces"),
+	TEXT("Record client moves and server results for every remote pawn to Saved/Traces. NT.RecordTraces [stop]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RecordNTTraces));
@@ -3,11 +3,13 @@
 #include "NTGame.h"
 #include "NTGame_MovementComponent.h"
 
-#include "GameFramework/GameNetworkManager.h"
 #include "NTGame_Pawn.h"
+#include "NTGame_MoveTrace.h"
+#include "NTGame_CorrectionHeatmap.h"
 
 // PhysX
 #include "PhysicsPublic.h"
+#include "PhysXPublic.h"
 #include "Runtime/Engine/Classes/PhysicsEngine/PhysicsSettings.h"
 #include "ThirdParty/PhysX/PhysX_3.4/include/PxScene.h"
 
@@ -45,6 +47,9 @@ UNTGame_MovementComponent::UNTGame_MovementComponent(const FObjectInitializer& O
 	Omega = FVector::ZeroVector;
 	Accel = FVector::ZeroVector;
 	Alpha = FVector::ZeroVector;
+	InputAccel = FVector::ZeroVector;
+	HoverGroundZ = 0.f;
+	bHasHoverGround = false;
 
 	// Movement Properties
 	ForwardSpeed = 200.f;
@@ -52,9 +57,59 @@ UNTGame_MovementComponent::UNTGame_MovementComponent(const FObjectInitializer& O
 	SteerSpeed = 30.f;
 	PitchSpeed = 25.f;
 	PitchLimits = FVector2D(-35.f, 35.f);
+	InputDelayFrames = 0;
+
+	// Idle Properties
+	bEnableIdleMode = true;
+	IdleVelocityThreshold = 1.f;
+	IdleHeartbeatInterval = 0.5f;
+
+	// Extrapolation Properties
+	bExtrapolateMissingInput = true;
+	MaxInputExtrapolationTime = 0.25f;
+	InputExtrapolationDecay = 0.f;
+
+	// Time Dilation Properties
+	bEnableTimeDilation = true;
+	TimeDilationUpdateInterval = 0.25f;
+	TimeDilationJitterMultiplier = 2.f;
+	TimeDilationGain = 0.5f;
+	MaxTimeDilation = 0.05f;
+
+	// Error Tolerance Properties
+	LocationErrorTolerance = 2.f;
+	RotationErrorTolerance = 2.f;
+	LinearVelocityErrorTolerance = 20.f;
+	AngularVelocityErrorTolerance = 10.f;
+	ErrorToleranceSpeedScale = 0.001f;
+	ErrorBudget = 0.1f;
+	MaxErrorScale = 4.f;
+
+	// Correction Properties
+	bLimitCorrections = true;
+	CorrectionAckTimeout = 0.25f;
+	bDeltaEncodeCorrections = true;
+
+	// Substepping
+	bApplyForcesPerSubstep = true;
+	FrameSubsteps = 1;
+	SubstepIndex = 0;
+	bCustomPhysicsRegistered = false;
+	OnCalculateCustomPhysics.BindUObject(this, &UNTGame_MovementComponent::SubstepPhysics);
+
+	// Analytical Replay
+	bEnableAnalyticalReplay = true;
+	AnalyticalReplaySweepMargin = 5.f;
+	bHadContactThisFrame = false;
+	bComponentNeedsSync = false;
+
+	// Replication
+	bReplicateAllBodies = false;
+	bQuantizeMoveState = false;
 
 	// Debugging
 	bDrawDebug = false;
+	MovementCycles = 0;
 	bEnableHoverSpring = false;
 }
 
@@ -82,6 +137,18 @@ void UNTGame_MovementComponent::RegisterComponentTickFunctions(bool bRegister)
 	}
 }
 
+void UNTGame_MovementComponent::Activate(bool bReset)
+{
+	Super::Activate(bReset);
+	PostPhysicsTickFunction.SetTickFunctionEnable(IsActive());
+}
+
+void UNTGame_MovementComponent::Deactivate()
+{
+	Super::Deactivate();
+	PostPhysicsTickFunction.SetTickFunctionEnable(false);
+}
+
 void FPawnMovementPostPhysicsTickFunction::ExecuteTick(float DeltaTime, enum ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
 {
 	FActorComponentTickFunction::ExecuteTickHelper(MoveComponent, false, DeltaTime, TickType, [this](float DilatedTime)
@@ -95,9 +162,16 @@ void UNTGame_MovementComponent::PostPhysicsTickComponent(float DeltaTime, FPawnM
 	const APawn* OwningPawn = Cast<APawn>(GetOwner());
 	ASSERTV(OwningPawn != nullptr, TEXT("Invalid Owner"));
 
+	const uint32 StartCycles = FPlatformTime::Cycles();
+
 	Omega = UpdatedPrimitive->GetPhysicsLinearVelocity();
 	Velocity = UpdatedPrimitive->GetPhysicsLinearVelocity();
 
+	// Physics has run, anything the substep callback didn't consume goes into next frame
+	FlushPendingForces();
+	SubstepIndex = 0;
+	bCustomPhysicsRegistered = false;
+
 	if (GetOwner()->Role > ROLE_SimulatedProxy)
 	{
 		const bool bIsClient = (GetOwner()->Role == ROLE_AutonomousProxy && GetNetMode() == NM_Client);
@@ -110,10 +184,18 @@ void UNTGame_MovementComponent::PostPhysicsTickComponent(float DeltaTime, FPawnM
 		{
 			// Server sends updates to remote clients
 			ServerMove_PostSim();
+
+			if (TraceRecorder.IsValid())
+			{
+				TraceRecorder->RecordServerStep(DeltaTime, GetCurrentMoveData());
+			}
 		}
 	}
 
 	UpdateComponentVelocity();
+	bHadContactThisFrame = false;
+
+	MovementCycles += FPlatformTime::Cycles() - StartCycles;
 }
 
 ////////////////////////////
@@ -128,6 +210,9 @@ void UNTGame_MovementComponent::TickComponent(float DeltaTime, enum ELevelTick T
 	const APawn* OwningPawn = Cast<APawn>(GetOwner());
 	ASSERTV(OwningPawn != nullptr, TEXT("Invalid Owner"));
 
+	const uint32 StartCycles = FPlatformTime::Cycles();
+	FrameSubsteps = ComputeNumSubsteps(DeltaTime);
+
 	if (GetOwner()->Role > ROLE_SimulatedProxy)
 	{
 		const bool bIsClient = (GetOwner()->Role == ROLE_AutonomousProxy && GetNetMode() == NM_Client);
@@ -148,8 +233,17 @@ void UNTGame_MovementComponent::TickComponent(float DeltaTime, enum ELevelTick T
 			else if (bIsClient)
 			{
 				// Local Client Updates it's pawn
+				// Accelerations use the dilated delta, same as the server will derive from our timestamps
 				ClientPrepareMove_PreSim();
-				PerformMovement(DeltaTime, InputData);
+				const FNetworkPredictionData_Client_Physics* ClientData = GetPredictionData_Client_Physics();
+				const float AccelDelta = ClientData ? DeltaTime * ClientData->TimeDilation : DeltaTime;
+				if (ClientData && ClientData->CurrentMove.IsValid())
+				{
+					// Replays have to apply the same impulse, whatever the dilation is by then
+					ClientData->CurrentMove->AccelDeltaTime = AccelDelta;
+				}
+
+				PerformMovement(AccelDelta, InputData);
 			}
 		}
 		else
@@ -158,7 +252,8 @@ void UNTGame_MovementComponent::TickComponent(float DeltaTime, enum ELevelTick T
 			{
 				// TODO: Servers need to smooth client updates here maybe?
 
-				if (OwningPawn->GetController() == nullptr)
+				// Pawns with a remote autonomous role get their moves through ServerMove instead
+				if (OwningPawn->GetController() == nullptr && OwningPawn->GetRemoteRole() != ROLE_AutonomousProxy)
 				{
 					PerformMovement(DeltaTime, InputData);
 				}
@@ -171,18 +266,50 @@ void UNTGame_MovementComponent::TickComponent(float DeltaTime, enum ELevelTick T
 		// Don't bother using input here
 		PerformMovement(DeltaTime, InputData);
 	}
+
+	MovementCycles += FPlatformTime::Cycles() - StartCycles;
 }
 
 void UNTGame_MovementComponent::PerformMovement(const float DeltaTime, const FRepPlayerInput& InInput)
 {
+	SCOPE_CYCLE_COUNTER(STAT_NTMovement_PerformMovement);
+
 	CalculateInputAcceleration(DeltaTime, InInput);
 
+	if (IsApplyingForcesPerSubstep())
+	{
+		// Queue the move's forces, the physics callback applies them over the following substeps
+		FNTGame_MoveForces& NewForces = PendingForces[PendingForces.AddDefaulted()];
+		NewForces.InputAccel = InputAccel;
+		NewForces.AngularAccel = Alpha;
+		NewForces.HoverGroundZ = HoverGroundZ;
+		NewForces.bHasHoverGround = bHasHoverGround;
+		NewForces.RemainingTime = DeltaTime;
+
+		if (!bCustomPhysicsRegistered)
+		{
+			UpdatedPrimitive->GetBodyInstance()->AddCustomPhysics(OnCalculateCustomPhysics);
+			bCustomPhysicsRegistered = true;
+		}
+		return;
+	}
+
 	UpdatedPrimitive->SetPhysicsLinearVelocity(Accel * DeltaTime, true);
 	UpdatedPrimitive->SetPhysicsAngularVelocity(Alpha * DeltaTime, true);
 }
 
+FVector UNTGame_MovementComponent::GetHoverAccel(const float InGroundZ, const float InHeight, const float InVelocityZ) const
+{
+	const float CompressionRatio = FMath::GetMappedRangeValueClamped(FVector2D(0.f, HoverSpring_Length), FVector2D(1.f, 0.f), InHeight - InGroundZ);
+	const float HoverAccelZ = (CompressionRatio * HoverSpring_Tension) + (-HoverSpring_Damping * InVelocityZ);
+
+	return FVector(0.f, 0.f, HoverAccelZ);
+}
+
 void UNTGame_MovementComponent::CalculateInputAcceleration(const float InDeltaTime, const FRepPlayerInput& InInput)
 {
+	SCOPE_CYCLE_COUNTER(STAT_NTMovement_CalculateInputAcceleration);
+
 	// Bit gross but ah well!
 	const ANTGame_Pawn* OwningNTPawn = Cast<ANTGame_Pawn>(GetOwner());
 	ASSERTV(OwningNTPawn != nullptr, TEXT("Invalid Owner Pawn"));
@@ -192,30 +319,115 @@ void UNTGame_MovementComponent::CalculateInputAcceleration(const float InDeltaTi
 	const FVector SteerAngRot = OwningNTPawn->GetViewCamera()->GetUpVector() * InInput.SteerAxis * SteerSpeed;
 	const FVector PitchAngRot = OwningNTPawn->GetViewCamera()->GetRightVector() * InInput.PitchAxis * PitchSpeed;
 
-	// Trace below for hovering
+	// Trace below for hovering. The ground is kept, so substeps can re-evaluate the spring against it.
 	FHitResult HoverHit = FHitResult();
-	const FVector Location = UpdatedComponent->GetComponentLocation();
 	FVector HoverAccel = FVector::ZeroVector;
+	bHasHoverGround = false;
 
 	if (bEnableHoverSpring)
 	{
+		// The component isn't synced during replays, so use the body
+		const FRepPawnMoveData BodyState = GetCurrentMoveData();
+		const FVector Location = BodyState.Location;
+
 		FCollisionQueryParams Params = FCollisionQueryParams();
 		Params.AddIgnoredActor(GetOwner());
 		Params.bTraceComplex = true;
 
 		if (GetWorld()->LineTraceSingleByChannel(HoverHit, Location, Location + FVector(0.f, 0.f, -HoverSpring_Length), ECC_Visibility, Params))
 		{
-			const float CompressionRatio = FMath::GetMappedRangeValueClamped(FVector2D(0.f, HoverSpring_Length), FVector2D(1.f, 0.f), Location.Z - HoverHit.Location.Z);
-			const float HoverAccelZ = (CompressionRatio * HoverSpring_Tension) + (-HoverSpring_Damping * Velocity.Z);
-
-			HoverAccel = FVector(0.f, 0.f, HoverAccelZ);
+			HoverGroundZ = HoverHit.Location.Z;
+			bHasHoverGround = true;
+			HoverAccel = GetHoverAccel(HoverGroundZ, Location.Z, BodyState.LinearVelocity.Z);
 		}
 	}
 
-	Accel = Thrust + Strafe + HoverAccel;
+	InputAccel = Thrust + Strafe;
+	Accel = InputAccel + HoverAccel;
 	Alpha = SteerAngRot + PitchAngRot;
 }
 
+///////////////////////
+///// Substepping /////
+///////////////////////
+
+int32 UNTGame_MovementComponent::ComputeNumSubsteps(const float DeltaTime)
+{
+	const UPhysicsSettings* Settings = UPhysicsSettings::Get();
+	if (Settings == nullptr || !Settings->bSubstepping) { return 1; }
+
+	const float PhysicsDelta = FMath::Min(DeltaTime, Settings->MaxPhysicsDeltaTime);
+	return FMath::Clamp(FMath::CeilToInt(PhysicsDelta / Settings->MaxSubstepDeltaTime), 1, Settings->MaxSubsteps);
+}
+
+bool UNTGame_MovementComponent::IsApplyingForcesPerSubstep() const
+{
+	return bApplyForcesPerSubstep && UPhysicsSettings::Get()->bSubstepping && UpdatedPrimitive && UpdatedPrimitive->GetBodyInstance();
+}
+
+void UNTGame_MovementComponent::SubstepPhysics(float SubstepDeltaTime, FBodyInstance* BodyInstance)
+{
+	// Called by the physics scene for each substep. The last substep of the frame takes whatever is left.
+	SubstepIndex++;
+	ConsumePendingForces(SubstepDeltaTime, SubstepIndex >= FrameSubsteps, BodyInstance);
+}
+
+void UNTGame_MovementComponent::ConsumePendingForces(const float SubstepDeltaTime, const bool bFlush, FBodyInstance* BodyInstance)
+{
+	if (PendingForces.Num() == 0 || BodyInstance == nullptr) { return; }
+
+	// Hover spring is evaluated against the body's state at this substep
+	const float BodyHeight = BodyInstance->GetUnrealWorldTransform_AssumesLocked().GetLocation().Z;
+	const float BodyVelocityZ = BodyInstance->GetUnrealWorldVelocity_AssumesLocked().Z;
+
+	FVector LinearDeltaV = FVector::ZeroVector;
+	FVector AngularDeltaV = FVector::ZeroVector;
+	ComputePendingDeltaV(SubstepDeltaTime, bFlush, BodyHeight, BodyVelocityZ, LinearDeltaV, AngularDeltaV);
+
+	// Angular acceleration is in degrees, same as SetPhysicsAngularVelocity
+	BodyInstance->AddImpulse(LinearDeltaV, true);
+	BodyInstance->AddAngularImpulse(FMath::DegreesToRadians(AngularDeltaV), true);
+}
+
+void UNTGame_MovementComponent::ComputePendingDeltaV(const float SubstepDeltaTime, const bool bFlush, const float BodyHeight, const float BodyVelocityZ, FVector& OutLinearDeltaV, FVector& OutAngularDeltaV)
+{
+	OutLinearDeltaV = FVector::ZeroVector;
+	OutAngularDeltaV = FVector::ZeroVector;
+	float TimeLeft = SubstepDeltaTime;
+
+	while (PendingForces.Num() > 0 && (TimeLeft > 0.f || bFlush))
+	{
+		FNTGame_MoveForces& Forces = PendingForces[0];
+		const float ApplyTime = bFlush ? Forces.RemainingTime : FMath::Min(TimeLeft, Forces.RemainingTime);
+
+		const FVector SubstepAccel = Forces.bHasHoverGround ? Forces.InputAccel + GetHoverAccel(Forces.HoverGroundZ, BodyHeight, BodyVelocityZ) : Forces.InputAccel;
+		OutLinearDeltaV += SubstepAccel * ApplyTime;
+		OutAngularDeltaV += Forces.AngularAccel * ApplyTime;
+
+		Forces.RemainingTime -= ApplyTime;
+		TimeLeft -= ApplyTime;
+
+		if (Forces.RemainingTime <= SMALL_NUMBER)
+		{
+			PendingForces.RemoveAt(0, 1, false);
+		}
+	}
+}
+
+void UNTGame_MovementComponent::FlushPendingForces()
+{
+	if (PendingForces.Num() == 0 || UpdatedPrimitive == nullptr) { return; }
+
+	for (const FNTGame_MoveForces& Forces : PendingForces)
+	{
+		const FVector HoverAccel = Forces.bHasHoverGround ? GetHoverAccel(Forces.HoverGroundZ, UpdatedPrimitive->GetComponentLocation().Z, Velocity.Z) : FVector::ZeroVector;
+		UpdatedPrimitive->SetPhysicsLinearVelocity((Forces.InputAccel + HoverAccel) * Forces.RemainingTime, true);
+		UpdatedPrimitive->SetPhysicsAngularVelocity(Forces.AngularAccel * Forces.RemainingTime, true);
+	}
+
+	PendingForces.Reset();
+}
+
 /////////////////////////
 ///// Replay Buffer /////
 /////////////////////////
@@ -233,8 +445,7 @@ void UNTGame_MovementComponent::ClientPrepareMove_PreSim()
 		return;
 	}
 
-	// Save pre-transform and physics state
-	ClientData->CurrentMove->PreUpdate(this);
+	ClientData->CurrentMove->NumSubsteps = (uint8)FrameSubsteps;
 }
 
 void UNTGame_MovementComponent::ClientPrepareMove_PostSim(const float DeltaTime)
@@ -253,22 +464,61 @@ void UNTGame_MovementComponent::ClientPrepareMove_PostSim(const float DeltaTime)
 
 	// Save Transform & Physics State
 	ClientData->CurrentMove->PostUpdate(this);
+	QuantizeMoveState(ClientData->CurrentMove->EndMoveData);
+	ClientData->CurrentMove->bHadContact = bHadContactThisFrame;
+
+	// If we're resting, only send a heartbeat every so often. The server treats missing moves as continued rest.
+	// Keep sending until the server has been told about the first resting move though.
+	const float WorldTime = GetWorld()->GetTimeSeconds();
+	const bool bAtRest = bEnableIdleMode && LatestControlInput == FRepPlayerInput() && IsAtRest(LastControlInput, ClientData->CurrentMove->EndMoveData);
+	if (bAtRest && ClientData->bLastMoveAtRest && (WorldTime - ClientData->ClientUpdateTime) < IdleHeartbeatInterval)
+	{
+		ClientData->FreeMove(ClientData->CurrentMove);
+		ClientData->CurrentMove = NULL;
+		return;
+	}
+
+	ClientData->bLastMoveAtRest = bAtRest;
+
 	ClientData->SavedMoves.Push(ClientData->CurrentMove);
-	ClientData->ClientUpdateTime = GetWorld()->GetTimeSeconds();
+	INC_DWORD_STAT(STAT_NTMovement_MovesSaved);
+	ClientData->ClientUpdateTime = WorldTime;
 
 	ClientData->CurrentMove->MoveTimestamp = ClientData->CurrentTimeStamp;
 	ClientData->CurrentMove->MoveInput = LastControlInput;
 	ClientData->CurrentMove->MoveDeltaTime = DeltaTime;
 
-	// Send Move To Server
-	ServerMove(ClientData->CurrentMove->MoveTimestamp, ClientData->CurrentMove->MoveInput, ClientData->CurrentMove->EndMoveData);
+	// Send Move To Server. The latest input is only useful to the server when it's delayed.
+	const FSavedPhysicsMovePtr& SentMove = ClientData->CurrentMove;
+	if (InputDelayFrames > 0)
+	{
+		BandwidthStats.RecordServerMove(SentMove->MoveInput, &LatestControlInput, SentMove->EndMoveData);
+		ServerMoveWithLatestInput(SentMove->MoveTimestamp, SentMove->MoveInput, LatestControlInput, SentMove->EndMoveData, ClientData->LastCorrectionId);
+	}
+	else
+	{
+		BandwidthStats.RecordServerMove(SentMove->MoveInput, nullptr, SentMove->EndMoveData);
+		ServerMove(SentMove->MoveTimestamp, SentMove->MoveInput, SentMove->EndMoveData, ClientData->LastCorrectionId);
+	}
 
 	// Reset Current Move
 	ClientData->CurrentMove = NULL;
 }
 
-void UNTGame_MovementComponent::ServerMove_Implementation(const float MoveTimeStamp, const FRepPlayerInput ClientInput, const FRepPawnMoveData& EndMoveData)
+void UNTGame_MovementComponent::ServerMove_Implementation(const float MoveTimeStamp, const FRepPlayerInput ClientInput, const FRepPawnMoveData& EndMoveData, const uint8 ClientCorrectionId)
 {
+	ServerProcessMove(MoveTimeStamp, ClientInput, nullptr, EndMoveData, ClientCorrectionId);
+}
+
+void UNTGame_MovementComponent::ServerMoveWithLatestInput_Implementation(const float MoveTimeStamp, const FRepPlayerInput ClientInput, const FRepPlayerInput ClientLatestInput, const FRepPawnMoveData& EndMoveData, const uint8 ClientCorrectionId)
+{
+	ServerProcessMove(MoveTimeStamp, ClientInput, &ClientLatestInput, EndMoveData, ClientCorrectionId);
+}
+
+void UNTGame_MovementComponent::ServerProcessMove(const float MoveTimeStamp, const FRepPlayerInput& ClientInput, const FRepPlayerInput* ClientLatestInput, const FRepPawnMoveData& EndMoveData, const uint8 ClientCorrectionId)
+{
+	SCOPE_CYCLE_COUNTER(STAT_NTMovement_ServerMove);
+
 	// This runs on the Server
 	FNetworkPredictionData_Server_Physics* ServerData = GetPredictionData_Server_Physics();
 	ASSERTV(ServerData != nullptr, TEXT("Invalid Server Data"));
@@ -284,6 +534,8 @@ void UNTGame_MovementComponent::ServerMove_Implementation(const float MoveTimeSt
 		return;
 	}
 
+	ServerData->ClientAckedCorrectionId = ClientCorrectionId;
+
 	FRepPlayerInput ClientInputCopy = ClientInput;
 	bool bServerReadyForClient = true;
 	
@@ -301,7 +553,16 @@ void UNTGame_MovementComponent::ServerMove_Implementation(const float MoveTimeSt
 	}
 
 	// Update Delta Time, given the last received client timestamp
-	const float AccelDelta = ServerData->GetServerMoveDeltaTime(MoveTimeStamp);
+	float AccelDelta = ServerData->GetServerMoveDeltaTime(MoveTimeStamp);
+
+	// A resting heartbeat's timestamp spans the whole idle gap, which ForcePositionUpdate has already simulated.
+	// Only integrate the last frame of it.
+	const bool bWasClientAtRest = ServerData->bClientAtRest;
+	ServerData->bClientAtRest = bEnableIdleMode && IsAtRest(ClientInputCopy, EndMoveData);
+	if (bWasClientAtRest && ServerData->bClientAtRest)
+	{
+		AccelDelta = FMath::Min(AccelDelta, GetWorld()->GetDeltaSeconds());
+	}
 
 	// Now update data
 	ServerData->CurrentClientTimeStamp = MoveTimeStamp;
@@ -313,13 +574,56 @@ void UNTGame_MovementComponent::ServerMove_Implementation(const float MoveTimeSt
 	if (AccelDelta <= 0.f) { return; }
 
 	ServerData->CreateProcessingMove(MoveTimeStamp, AccelDelta, ClientInputCopy, EndMoveData);
+	ServerData->LastClientInput = ClientInputCopy;
+
+	if (TraceRecorder.IsValid())
+	{
+		TraceRecorder->RecordClientMove(MoveTimeStamp, AccelDelta, ClientInputCopy, EndMoveData);
+	}
+
+	// Delayed inputs arrive ahead of the moves that use them, keep hold of them for extrapolation. Moves can arrive out of order.
+	ServerData->NumFutureInputsUsed = 0;
+	if (InputDelayFrames > 0 && ClientLatestInput)
+	{
+		int32 InsertIdx = ServerData->FutureClientInputs.Num();
+		while (InsertIdx > 0 && ServerData->FutureClientInputs[InsertIdx - 1].TimeStamp > MoveTimeStamp)
+		{
+			InsertIdx--;
+		}
+
+		ServerData->FutureClientInputs.Insert(FNTGame_FutureInput(MoveTimeStamp, *ClientLatestInput), InsertIdx);
+		if (ServerData->FutureClientInputs.Num() > InputDelayFrames)
+		{
+			ServerData->FutureClientInputs.RemoveAt(0, ServerData->FutureClientInputs.Num() - InputDelayFrames, false);
+		}
+	}
+
+	// Undo any guesses we made for the time this move covers
+	ServerReconcileExtrapolatedInput(*ServerData);
 
 	// Run pre-sim movement code
 	PerformMovement(AccelDelta, ClientInputCopy);
 }
 
+void UNTGame_MovementComponent::ServerReconcileExtrapolatedInput(FNetworkPredictionData_Server_Physics& ServerData)
+{
+	if (ServerData.ExtrapolatedTime <= 0.f) { return; }
+
+	// Whatever we guessed (damping, hover spring and contacts included) is thrown away. The late move, and the ones after it, replay that time with real input.
+	Velocity = ServerData.PreExtrapolationState.LinearVelocity;
+	Omega = ServerData.PreExtrapolationState.AngularVelocity;
+	SetCurrentMoveData(ServerData.PreExtrapolationState);
+	SetBodySnapshot(ServerData.PreExtrapolationBodies);
+	SyncComponentToBody();
+
+	ServerData.ExtrapolatedTime = 0.f;
+	ServerData.PreExtrapolationBodies.Bodies.Reset();
+}
+
 void UNTGame_MovementComponent::ServerMove_PostSim()
 {
+	SCOPE_CYCLE_COUNTER(STAT_NTMovement_ServerMovePostSim);
+
 	// Check For Differences
 	FNetworkPredictionData_Server_Physics* ServerData = GetPredictionData_Server_Physics();
 	ASSERTV(ServerData != nullptr, TEXT("Invalid Server Data"));
@@ -328,36 +632,116 @@ void UNTGame_MovementComponent::ServerMove_PostSim()
 
 	// Update Post Move Data
 	ServerData->CurrentlyProcessingClientMove->PostUpdate(this);
+	QuantizeMoveState(ServerData->CurrentlyProcessingClientMove->EndMoveData);
 
-	// Now check if the client simulated incorrectly (client data is stored as 'Start Move Data')
-	const bool bBadClientSim = ServerCheckClientError(ServerData->CurrentlyProcessingClientMove);
-	if (ServerData->bForceClientUpdate || bBadClientSim)
+	// Now check if the client simulated incorrectly (client data is stored as 'Client End Move Data')
+	const FSavedPhysicsMovePtr& ClientMove = ServerData->CurrentlyProcessingClientMove;
+	const float ErrorScale = ServerGetClientErrorScale(ServerData->ClientEndMoveData, ClientMove->EndMoveData);
+	if (ErrorScale <= MaxErrorScale)
+	{
+		// Small errors spend the budget while they last, and earn it back while the client is within tolerance
+		ServerData->AccumulatedClientError = FMath::Max(ServerData->AccumulatedClientError + (ErrorScale - 1.f) * ClientMove->MoveDeltaTime, 0.f);
+	}
+
+	const bool bBadClientSim = ServerCheckClientError(ErrorScale, ServerData->AccumulatedClientError);
+
+	// Client made this move before it got our last correction, and will replay it from there anyway
+	const bool bHoldCorrection = bBadClientSim && !ServerData->bForceClientUpdate && ServerIsCorrectionInFlight(*ServerData);
+	if (!bHoldCorrection && (ServerData->bForceClientUpdate || bBadClientSim))
 	{
 		// Move wasn't okay, send correct result of this move.
 		// Client will have to re simulate moves created after this one (without re-sending them?)
-		ClientAckBadMove(ServerData->CurrentlyProcessingClientMove->MoveTimestamp, ServerData->CurrentlyProcessingClientMove->EndMoveData);
+		INC_DWORD_STAT(STAT_NTMovement_MovesCorrected);
+		ServerData->NumBadMoves++;
+		ServerData->AccumulatedClientError = 0.f;
+
+		// The client still holds the state it reported, unless one of our corrections has replayed the move since it was sent
+		const FSavedPhysicsMovePtr& BadMove = ServerData->CurrentlyProcessingClientMove;
+		const bool bClientStateIntact = ServerData->ClientAckedCorrectionId == ServerData->PendingCorrectionId;
+		const FRepPawnMoveCorrection Correction = (bDeltaEncodeCorrections && bClientStateIntact) ? FRepPawnMoveCorrection::Make(BadMove->EndMoveData, ServerData->ClientEndMoveData) : FRepPawnMoveCorrection(BadMove->EndMoveData);
+
+		ServerData->PendingCorrectionId++;
+		ServerData->PendingCorrectionTime = GetWorld()->GetTimeSeconds();
+		if (bBadClientSim)
+		{
+			Server_RecordCorrection(ServerData->ClientEndMoveData, BadMove->EndMoveData);
+		}
+
+		// Other bodies are only needed for the correction, so they're only read here
+		GetBodySnapshot(ServerData->CorrectionBodies);
+
+		BandwidthStats.RecordAckBadMove(Correction, ServerData->CorrectionBodies);
+		if (ServerHasClientConnection())
+		{
+			ClientAckBadMove(BadMove->MoveTimestamp, Correction, ServerData->CorrectionBodies, ServerData->PendingCorrectionId);
+		}
 	}
 	else
 	{
-		// Move was okay, acknowledge it		
-		ClientAckGoodMove(ServerData->CurrentlyProcessingClientMove->MoveTimestamp);
+		// Move was okay, acknowledge it. Held moves are acked too, or the client never frees them and gets no RTT sample.
+		if (bHoldCorrection)
+		{
+			INC_DWORD_STAT(STAT_NTMovement_CorrectionsHeld);
+		}
+		else
+		{
+			INC_DWORD_STAT(STAT_NTMovement_MovesAcked);
+			ServerData->NumGoodMoves++;
+		}
+
+		BandwidthStats.RecordAckGoodMove();
+		if (ServerHasClientConnection())
+		{
+			ClientAckGoodMove(ServerData->CurrentlyProcessingClientMove->MoveTimestamp);
+		}
 	}
 
 	ServerData->CurrentlyProcessingClientMove = NULL;
 	ServerData->bForceClientUpdate = false;
 }
 
-bool UNTGame_MovementComponent::ServerCheckClientError(const FSavedPhysicsMovePtr& CurrentlyProcessingClientMove) const
+bool UNTGame_MovementComponent::ServerHasClientConnection() const
 {
-	const FVector LocDiff = CurrentlyProcessingClientMove->EndMoveData.Location - CurrentlyProcessingClientMove->StartMoveData.Location;
-//	GEngine->AddOnScreenDebugMessage(-1, 10.f, FColor::Red, FString::SanitizeFloat(FVector::DotProduct(LocDiff, LocDiff)));
+	return GetOwner() != nullptr && GetOwner()->GetNetConnection() != nullptr;
+}
 
-	if (GetDefault<AGameNetworkManager>()->ExceedsAllowablePositionError(LocDiff))
-	{
-		return true;
-	}
+bool UNTGame_MovementComponent::IsAtRest(const FRepPlayerInput& InInput, const FRepPawnMoveData& InMoveData) const
+{
+	if (InInput != FRepPlayerInput()) { return false; }
+
+	// Judged from the move alone, it may not be our body's current state. Sleeping bodies report zero velocity anyway.
+	const float ThresholdSq = FMath::Square(IdleVelocityThreshold);
+	return InMoveData.LinearVelocity.SizeSquared() < ThresholdSq && InMoveData.AngularVelocity.SizeSquared() < ThresholdSq;
+}
+
+bool UNTGame_MovementComponent::ServerCheckClientError(const float ErrorScale, const float AccumulatedError) const
+{
+	// Large errors are corrected straight away, small ones only once they've used up the budget
+	return ErrorScale > MaxErrorScale || (ErrorScale > 1.f && AccumulatedError > ErrorBudget);
+}
+
+bool UNTGame_MovementComponent::ServerIsCorrectionInFlight(const FNetworkPredictionData_Server_Physics& ServerData) const
+{
+	if (!bLimitCorrections || ServerData.PendingCorrectionId == ServerData.ClientAckedCorrectionId) { return false; }
+
+	// Corrections are unreliable, if it hasn't been applied within a round trip it was probably lost
+	const APawn* MyPawn = Cast<APawn>(GetOwner());
+	const float RTT = (MyPawn && MyPawn->PlayerState) ? MyPawn->PlayerState->ExactPing * 0.001f : 0.f;
+	return (GetWorld()->GetTimeSeconds() - ServerData.PendingCorrectionTime) < (RTT + CorrectionAckTimeout);
+}
 
-	return false;
+float UNTGame_MovementComponent::ServerGetClientErrorScale(const FRepPawnMoveData& ClientData, const FRepPawnMoveData& ServerData) const
+{
+	// Fast pawns get more room, small deviations at speed aren't worth a correction
+	const float SpeedScale = 1.f + ServerData.LinearVelocity.Size() * ErrorToleranceSpeedScale;
+
+	const float LocationError = FVector::Dist(ClientData.Location, ServerData.Location) / FMath::Max(LocationErrorTolerance * SpeedScale, KINDA_SMALL_NUMBER);
+	const float RotationError = FMath::RadiansToDegrees(ClientData.Rotation.AngularDistance(ServerData.Rotation)) / FMath::Max(RotationErrorTolerance * SpeedScale, KINDA_SMALL_NUMBER);
+	const float LinearVelocityError = FVector::Dist(ClientData.LinearVelocity, ServerData.LinearVelocity) / FMath::Max(LinearVelocityErrorTolerance * SpeedScale, KINDA_SMALL_NUMBER);
+	const float AngularVelocityError = FVector::Dist(ClientData.AngularVelocity, ServerData.AngularVelocity) / FMath::Max(AngularVelocityErrorTolerance * SpeedScale, KINDA_SMALL_NUMBER);
+
+	// Worst component, as a multiple of its tolerance
+	return FMath::Max(FMath::Max(LocationError, RotationError), FMath::Max(LinearVelocityError, AngularVelocityError));
 }
 
 void UNTGame_MovementComponent::ClientAckGoodMove_Implementation(const float MoveTimestamp)
@@ -382,7 +766,17 @@ void UNTGame_MovementComponent::ClientAckGoodMove_Implementation(const float Mov
 	// Tell Debug HUD
 }
 
-void UNTGame_MovementComponent::ClientAckBadMove_Implementation(const float MoveTimeStamp, const FRepPawnMoveData& ServerEndMoveData)
+void UNTGame_MovementComponent::ClientUpdateMoveLead_Implementation(const int8 LeadErrorMS)
+{
+	FNetworkPredictionData_Client_Physics* ClientData = GetPredictionData_Client_Physics();
+	ASSERTV(ClientData != nullptr, TEXT("Invalid Client Data"));
+
+	// Positive error means our moves arrive too early, so slow down. Negative means the server is starved, so speed up.
+	const float LeadError = (float)LeadErrorMS / 1000.f;
+	ClientData->TimeDilation = 1.f - FMath::Clamp(LeadError * TimeDilationGain, -MaxTimeDilation, MaxTimeDilation);
+}
+
+void UNTGame_MovementComponent::ClientAckBadMove_Implementation(const float MoveTimeStamp, const FRepPawnMoveCorrection& ServerCorrection, const FRepPawnBodySnapshot& ServerEndBodies, const uint8 CorrectionId)
 {
 	FNetworkPredictionData_Client_Physics* ClientData = GetPredictionData_Client_Physics();
 	ASSERTV(ClientData != nullptr, TEXT("Invalid Client Data"));
@@ -399,6 +793,11 @@ void UNTGame_MovementComponent::ClientAckBadMove_Implementation(const float Move
 	}
 	
 	ClientData->AcknowledgeMove(AckedMoveIndex);
+	ClientData->NumCorrections++;
+	ClientData->LastCorrectionId = CorrectionId;
+
+	// Deltas are from the state we sent for this move, which is now the last acked move
+	const FRepPawnMoveData ServerEndMoveData = ServerCorrection.Resolve(ClientData->LastAckedMove->EndMoveData);
 		
 	// We want to replay all moves from the acknowledged move onwards, before running physics next tick.
 	// Set client to servers' physics state, ready for replay
@@ -406,9 +805,9 @@ void UNTGame_MovementComponent::ClientAckBadMove_Implementation(const float Move
 	Velocity = ServerEndMoveData.LinearVelocity;
 	Omega = ServerEndMoveData.AngularVelocity;
 
-	UpdatedPrimitive->SetWorldLocationAndRotation(ServerEndMoveData.Location, ServerEndMoveData.Rotation, false, nullptr, ETeleportType::TeleportPhysics);
-	UpdatedPrimitive->SetAllPhysicsLinearVelocity(Velocity);
-	UpdatedPrimitive->SetAllPhysicsAngularVelocity(Omega);
+	// Component is synced once the replay has finished
+	SetCurrentMoveData(ServerEndMoveData);
+	SetBodySnapshot(ServerEndBodies);
 
 	GEngine->AddOnScreenDebugMessage(-1, 0.03f, FColor::Red, TEXT("Ack Bad Move"));
 }
@@ -419,6 +818,8 @@ void UNTGame_MovementComponent::ClientAckBadMove_Implementation(const float Move
 
 bool UNTGame_MovementComponent::ClientConditionalReplayBadMoves()
 {
+	SCOPE_CYCLE_COUNTER(STAT_NTMovement_ClientReplayBadMoves);
+
 	FNetworkPredictionData_Client_Physics* ClientData = GetPredictionData_Client_Physics();
 	ASSERTV_WR(ClientData != nullptr, false, TEXT("Invalid Client Data"));
 
@@ -427,7 +828,8 @@ bool UNTGame_MovementComponent::ClientConditionalReplayBadMoves()
 
 	if (ClientData->SavedMoves.Num() == 0)
 	{
-		// No saved moves to replay
+		// No saved moves to replay, just take the server's state
+		SyncComponentToBody();
 		return false;
 	}
 
@@ -438,22 +840,40 @@ bool UNTGame_MovementComponent::ClientConditionalReplayBadMoves()
 	{
 		const FSavedPhysicsMovePtr& CurrentMove = ClientData->SavedMoves[Idx];
 
-		// Update this move, so it has our current physics state (either from the Server, or after we recalc a move)
-		CurrentMove->PreUpdate(this);
+		// Each move starts from the end state of the one before it (either from the Server, or after we recalc a move)
 		ReplayMove(CurrentMove);
 		CurrentMove->PostUpdate(this);
+		QuantizeMoveState(CurrentMove->EndMoveData);
 	}
 
+	SyncComponentToBody();
+
+	INC_DWORD_STAT_BY(STAT_NTMovement_MovesReplayed, ClientData->SavedMoves.Num());
+	ClientData->NumMovesReplayed += ClientData->SavedMoves.Num();
+
 	// Now set physics state based on our latest move
 	return ClientData->SavedMoves.Num() > 0;
 }
 
 void UNTGame_MovementComponent::ReplayMove(const FSavedPhysicsMovePtr& InMove)
 {
+	SCOPE_CYCLE_COUNTER(STAT_NTMovement_ReplayMove);
+
 	// Perform Movement First
-	PerformMovement(InMove->MoveDeltaTime, InMove->MoveInput);
+	PerformMovement(InMove->AccelDeltaTime, InMove->MoveInput);
+
+	// Nothing was touched, so the body can be integrated on its own
+	if (bEnableAnalyticalReplay && !InMove->bHadContact && ReplayMoveAnalytically(InMove))
+	{
+		return;
+	}
 
 	// Now Simulate the PhysX Scene
+	SimulatePhysicsScene(InMove->MoveDeltaTime, InMove->NumSubsteps);
+}
+
+void UNTGame_MovementComponent::SimulatePhysicsScene(const float DeltaTime, const int32 NumSubsteps)
+{
 	// This is kind of shit, because it simulates the entire scene at this rate and we haven't reset any other objects.
 	// It also means that ALL other objects on the client will end up in the wrong position, until we get an update for them too.
 	// In future, this re-simulation needs to be done in a different scene, possibly with duplicated static bodies to reduce desyncs.
@@ -475,8 +895,23 @@ void UNTGame_MovementComponent::ReplayMove(const FSavedPhysicsMovePtr& InMove)
 			// Could also create a permanent buffer with a custom scene
 			uint8* Buffer = (uint8*)FMemory::Malloc(SceneScratchBufferSize, 16);
 
-			WorldPxScene->simulate(InMove->MoveDeltaTime, nullptr, Buffer, SceneScratchBufferSize, true);
-			WorldPxScene->fetchResults(true);
+			// Step the same way the move was originally simulated, applying queued forces each substep
+			const int32 StepCount = FMath::Max(NumSubsteps, 1);
+			const float StepDelta = DeltaTime / (float)StepCount;
+			FBodyInstance* BodyInstance = UpdatedPrimitive->GetBodyInstance();
+
+			for (int32 StepIdx = 0; StepIdx < StepCount; StepIdx++)
+			{
+				if (BodyInstance && IsApplyingForcesPerSubstep())
+				{
+					ConsumePendingForces(StepDelta, StepIdx == StepCount - 1, BodyInstance);
+				}
+
+				WorldPxScene->simulate(StepDelta, nullptr, Buffer, SceneScratchBufferSize, true);
+				WorldPxScene->fetchResults(true);
+			}
+
+			bComponentNeedsSync = true;
 
 			// Free the Scratch Buffer
 			FMemory::Free(Buffer);
@@ -501,15 +936,161 @@ void UNTGame_MovementComponent::ReplayMove(const FSavedPhysicsMovePtr& InMove)
 // 		}
 }
 
+//////////////////////
+///// Body State /////
+//////////////////////
+
+// Only single body primitives can be read / written directly, anything else goes through the component
+static PxRigidDynamic* GetSingleRigidDynamic(const UPrimitiveComponent* InPrimitive)
+{
+	const USkeletalMeshComponent* SkelMeshComp = Cast<USkeletalMeshComponent>(InPrimitive);
+	if (InPrimitive == nullptr || (SkelMeshComp && SkelMeshComp->Bodies.Num() > 1)) { return nullptr; }
+
+	const FBodyInstance* BodyInstance = InPrimitive->GetBodyInstance();
+	return BodyInstance ? BodyInstance->GetPxRigidDynamic_AssumesLocked() : nullptr;
+}
+
+FRepPawnMoveData UNTGame_MovementComponent::GetCurrentMoveData() const
+{
+	PxRigidDynamic* PRigidDynamic = GetSingleRigidDynamic(UpdatedPrimitive);
+	if (PRigidDynamic == nullptr || PRigidDynamic->getScene() == nullptr)
+	{
+		return FRepPawnMoveData(UpdatedPrimitive->GetComponentLocation(), UpdatedPrimitive->GetComponentQuat(), UpdatedPrimitive->GetPhysicsLinearVelocity(), UpdatedPrimitive->GetPhysicsAngularVelocity());
+	}
+
+	SCOPED_SCENE_READ_LOCK(PRigidDynamic->getScene());
+	const PxTransform Pose = PRigidDynamic->getGlobalPose();
+
+	// Angular velocity is stored in degrees, same as the component getters
+	return FRepPawnMoveData(P2UVector(Pose.p), P2UQuat(Pose.q), P2UVector(PRigidDynamic->getLinearVelocity()), FMath::RadiansToDegrees(P2UVector(PRigidDynamic->getAngularVelocity())));
+}
+
+void UNTGame_MovementComponent::SetCurrentMoveData(const FRepPawnMoveData& InMoveData)
+{
+	PxRigidDynamic* PRigidDynamic = GetSingleRigidDynamic(UpdatedPrimitive);
+	if (PRigidDynamic == nullptr || PRigidDynamic->getScene() == nullptr)
+	{
+		UpdatedPrimitive->SetWorldLocationAndRotation(InMoveData.Location, InMoveData.Rotation, false, nullptr, ETeleportType::TeleportPhysics);
+		UpdatedPrimitive->SetAllPhysicsLinearVelocity(InMoveData.LinearVelocity);
+		UpdatedPrimitive->SetAllPhysicsAngularVelocity(InMoveData.AngularVelocity);
+		return;
+	}
+
+	{
+		SCOPED_SCENE_WRITE_LOCK(PRigidDynamic->getScene());
+		PRigidDynamic->setGlobalPose(PxTransform(U2PVector(InMoveData.Location), U2PQuat(InMoveData.Rotation)));
+		PRigidDynamic->setLinearVelocity(U2PVector(InMoveData.LinearVelocity));
+		PRigidDynamic->setAngularVelocity(U2PVector(FMath::DegreesToRadians(InMoveData.AngularVelocity)));
+	}
+
+	bComponentNeedsSync = true;
+}
+
+void UNTGame_MovementComponent::GetBodySnapshot(FRepPawnBodySnapshot& OutSnapshot) const
+{
+	OutSnapshot.Bodies.Reset();
+
+	const USkeletalMeshComponent* SkelMeshComp = Cast<USkeletalMeshComponent>(UpdatedPrimitive);
+	if (!bReplicateAllBodies || SkelMeshComp == nullptr || SkelMeshComp->Bodies.Num() < 2) { return; }
+
+	const FBodyInstance* RootBody = SkelMeshComp->GetBodyInstance();
+	const PxRigidDynamic* PRootDynamic = RootBody ? RootBody->GetPxRigidDynamic_AssumesLocked() : nullptr;
+	if (PRootDynamic == nullptr || PRootDynamic->getScene() == nullptr) { return; }
+
+	// All bodies are read in the one lock
+	SCOPED_SCENE_READ_LOCK(PRootDynamic->getScene());
+	const PxTransform RootPose = PRootDynamic->getGlobalPose();
+	const PxVec3 RootLinearVelocity = PRootDynamic->getLinearVelocity();
+	const PxVec3 RootAngularVelocity = PRootDynamic->getAngularVelocity();
+
+	OutSnapshot.Bodies.Reserve(SkelMeshComp->Bodies.Num() - 1);
+	for (const FBodyInstance* Body : SkelMeshComp->Bodies)
+	{
+		if (Body == RootBody) { continue; }
+
+		// Missing bodies keep their slot, so indices match on the other end
+		const PxRigidDynamic* PDynamic = Body ? Body->GetPxRigidDynamic_AssumesLocked() : nullptr;
+		if (PDynamic == nullptr)
+		{
+			OutSnapshot.Bodies.AddDefaulted();
+			continue;
+		}
+
+		const PxTransform LocalPose = RootPose.transformInv(PDynamic->getGlobalPose());
+		const PxVec3 LocalLinearVelocity = RootPose.q.rotateInv(PDynamic->getLinearVelocity() - RootLinearVelocity);
+		const PxVec3 LocalAngularVelocity = RootPose.q.rotateInv(PDynamic->getAngularVelocity() - RootAngularVelocity);
+
+		OutSnapshot.Bodies.Add(FRepPawnMoveData(P2UVector(LocalPose.p), P2UQuat(LocalPose.q), P2UVector(LocalLinearVelocity), FMath::RadiansToDegrees(P2UVector(LocalAngularVelocity))));
+	}
+}
+
+void UNTGame_MovementComponent::SetBodySnapshot(const FRepPawnBodySnapshot& InSnapshot)
+{
+	USkeletalMeshComponent* SkelMeshComp = Cast<USkeletalMeshComponent>(UpdatedPrimitive);
+	if (SkelMeshComp == nullptr || InSnapshot.Bodies.Num() == 0 || InSnapshot.Bodies.Num() != SkelMeshComp->Bodies.Num() - 1) { return; }
+
+	const FBodyInstance* RootBody = SkelMeshComp->GetBodyInstance();
+	const PxRigidDynamic* PRootDynamic = RootBody ? RootBody->GetPxRigidDynamic_AssumesLocked() : nullptr;
+	if (PRootDynamic == nullptr || PRootDynamic->getScene() == nullptr) { return; }
+
+	SCOPED_SCENE_WRITE_LOCK(PRootDynamic->getScene());
+	const PxTransform RootPose = PRootDynamic->getGlobalPose();
+	const PxVec3 RootLinearVelocity = PRootDynamic->getLinearVelocity();
+	const PxVec3 RootAngularVelocity = PRootDynamic->getAngularVelocity();
+
+	int32 SnapshotIdx = 0;
+	for (FBodyInstance* Body : SkelMeshComp->Bodies)
+	{
+		if (Body == RootBody) { continue; }
+
+		const FRepPawnMoveData& BodyData = InSnapshot.Bodies[SnapshotIdx++];
+		PxRigidDynamic* PDynamic = Body ? Body->GetPxRigidDynamic_AssumesLocked() : nullptr;
+		if (PDynamic == nullptr || (PDynamic->getRigidBodyFlags() & PxRigidBodyFlag::eKINEMATIC)) { continue; }
+
+		const PxTransform LocalPose = PxTransform(U2PVector(BodyData.Location), U2PQuat(BodyData.Rotation.GetNormalized()));
+		PDynamic->setGlobalPose(RootPose.transform(LocalPose));
+		PDynamic->setLinearVelocity(RootLinearVelocity + RootPose.q.rotate(U2PVector(BodyData.LinearVelocity)));
+		PDynamic->setAngularVelocity(RootAngularVelocity + RootPose.q.rotate(U2PVector(FMath::DegreesToRadians(BodyData.AngularVelocity))));
+	}
+
+	bComponentNeedsSync = true;
+}
+
+void UNTGame_MovementComponent::QuantizeMoveState(FRepPawnMoveData& InOutMoveData)
+{
+	// Multi-body pawns would need every body snapped too, leave them be. Writing the pose would also wake a sleeping body.
+	if (!bQuantizeMoveState || GetSingleRigidDynamic(UpdatedPrimitive) == nullptr || !UpdatedPrimitive->RigidBodyIsAwake()) { return; }
+
+	InOutMoveData.Quantize();
+	SetCurrentMoveData(InOutMoveData);
+}
+
+void UNTGame_MovementComponent::SyncComponentToBody()
+{
+	if (!bComponentNeedsSync || UpdatedPrimitive == nullptr) { return; }
+
+	UpdatedPrimitive->SyncComponentToRBPhysics();
+	bComponentNeedsSync = false;
+}
+
 /////////////////
 ///// Input /////
 /////////////////
 
 FRepPlayerInput UNTGame_MovementComponent::ComputeAndConsumeInput()
 {
-	LastControlInput = RawControlInput;
+	LatestControlInput = RawControlInput;
 	RawControlInput = FRepPlayerInput();
 
+	// Queue the input and apply it InputDelayFrames ticks later. With no delay it's applied straight away.
+	DelayedControlInputs.Add(LatestControlInput);
+	LastControlInput = FRepPlayerInput();
+	while (DelayedControlInputs.Num() > InputDelayFrames)
+	{
+		LastControlInput = DelayedControlInputs[0];
+		DelayedControlInputs.RemoveAt(0, 1, false);
+	}
+
 	return LastControlInput;
 }
 
@@ -526,7 +1107,7 @@ FNetworkPredictionData_Client* UNTGame_MovementComponent::GetPredictionData_Clie
 	if (!ClientPredictionData)
 	{
 		UNTGame_MovementComponent* MutableThis = const_cast<UNTGame_MovementComponent*>(this);
-		MutableThis->ClientPredictionData = new FNetworkPredictionData_Client_Physics();
+		MutableThis->ClientPredictionData = new FNetworkPredictionData_Client_Physics(GetWorld());
 	}
 
 	return ClientPredictionData;
@@ -566,6 +1147,25 @@ void UNTGame_MovementComponent::ResetPredictionData_Server()
 	}
 }
 
+void UNTGame_MovementComponent::ResetMovementState()
+{
+	StopMovementImmediately();
+	Omega = FVector::ZeroVector;
+	Accel = FVector::ZeroVector;
+	Alpha = FVector::ZeroVector;
+
+	RawControlInput = FRepPlayerInput();
+	LatestControlInput = FRepPlayerInput();
+	LastControlInput = FRepPlayerInput();
+	DelayedControlInputs.Reset();
+	PendingForces.Reset();
+	bHadContactThisFrame = false;
+
+	// Timestamps and correction ids start again with the next owner
+	ResetPredictionData_Client();
+	ResetPredictionData_Server();
+}
+
 ////////////////////////////////////////
 ///// Network Prediction Interface /////
 ////////////////////////////////////////
@@ -588,18 +1188,110 @@ void UNTGame_MovementComponent::ForcePositionUpdate(float DeltaTime)
 	ASSERTV(GetOwner()->Role == ROLE_Authority, TEXT("No Authority to Force Position Update"));
 	ASSERTV(GetOwner()->GetRemoteRole() == ROLE_AutonomousProxy, TEXT("Invalid Remote Role"));
 
-	UE_LOG(LogNTGameMovement, Warning, TEXT("Server called ForcePositionUpdate with %f DeltaTime. Max = %f, delta may be clamped."), DeltaTime, MaxSimulationTimeStep);
+	// Resting clients only send heartbeats, so this is expected
+	FNetworkPredictionData_Server_Physics* ServerData = GetPredictionData_Server_Physics();
+	const bool bClientAtRest = ServerData != nullptr && ServerData->bClientAtRest;
+
+	UE_CLOG(!bClientAtRest, LogNTGameMovement, Warning, TEXT("Server called ForcePositionUpdate with %f DeltaTime. Max = %f, delta may be clamped."), DeltaTime, MaxSimulationTimeStep);
 
 	// Clamp the maximum time step so we don't get huge deltas if we haven't had an update for a long time.
 	// This can cause forces to go crazy otherwise
 	const float ForcedSimAccelDelta = FMath::Min(DeltaTime, MaxSimulationTimeStep);
-	PerformMovement(ForcedSimAccelDelta, FRepPlayerInput());
+
+	// Keep predicting with the last input we received for a bounded window, otherwise assume no input.
+	if (bExtrapolateMissingInput && ServerData && ServerData->ExtrapolatedTime < MaxInputExtrapolationTime)
+	{
+		const float ExtrapolationDelta = FMath::Min(ForcedSimAccelDelta, MaxInputExtrapolationTime - ServerData->ExtrapolatedTime);
+		if (ServerData->ExtrapolatedTime <= 0.f)
+		{
+			// Where we were before guessing, restored when the real moves turn up
+			ServerData->PreExtrapolationState = GetCurrentMoveData();
+			GetBodySnapshot(ServerData->PreExtrapolationBodies);
+		}
+
+		const float InputScale = InputExtrapolationDecay > 0.f ? FMath::Exp(-InputExtrapolationDecay * ServerData->ExtrapolatedTime) : 1.f;
+
+		// If the client is delaying input, we already know what it's going to do next. Each missing move uses the next one along.
+		FRepPlayerInput ExtrapolatedInput = ServerData->LastClientInput;
+		if (ServerData->FutureClientInputs.IsValidIndex(ServerData->NumFutureInputsUsed))
+		{
+			ExtrapolatedInput = ServerData->FutureClientInputs[ServerData->NumFutureInputsUsed].Input;
+			ServerData->NumFutureInputsUsed++;
+		}
+
+		ExtrapolatedInput.ForwardAxis *= InputScale;
+		ExtrapolatedInput.StrafeAxis *= InputScale;
+		ExtrapolatedInput.SteerAxis *= InputScale;
+		ExtrapolatedInput.PitchAxis *= InputScale;
+
+		PerformMovement(ExtrapolationDelta, ExtrapolatedInput);
+		ServerData->ExtrapolatedTime += ExtrapolationDelta;
+
+		if (ExtrapolationDelta < ForcedSimAccelDelta)
+		{
+			PerformMovement(ForcedSimAccelDelta - ExtrapolationDelta, FRepPlayerInput());
+		}
+	}
+	else
+	{
+		PerformMovement(ForcedSimAccelDelta, FRepPlayerInput());
+	}
 }
 
 /////////////////////
 ///// Debugging /////
 /////////////////////
 
+void UNTGame_MovementComponent::StartMoveTrace(const FString& InFilename)
+{
+	ASSERTV(GetOwner() != nullptr && GetOwner()->Role == ROLE_Authority, TEXT("Move traces can only be recorded on the server"));
+
+	FNTGame_MoveTraceHeader Header = FNTGame_MoveTraceHeader();
+	Header.MapName = UWorld::RemovePIEPrefix(GetWorld()->GetOutermost()->GetName());
+	Header.PawnClassPath = GetOwner()->GetClass()->GetPathName();
+	Header.InitialState = GetCurrentMoveData();
+
+	TraceRecorder = MakeShareable(new FNTGame_MoveTraceRecorder());
+	if (!TraceRecorder->Start(InFilename, Header))
+	{
+		TraceRecorder.Reset();
+	}
+}
+
+void UNTGame_MovementComponent::StopMoveTrace()
+{
+	if (TraceRecorder.IsValid())
+	{
+		TraceRecorder->Stop();
+		TraceRecorder.Reset();
+	}
+}
+
+void UNTGame_MovementComponent::Server_RecordCorrection(const FRepPawnMoveData& InClientData, const FRepPawnMoveData& InServerData) const
+{
+	if (!FNTGame_CorrectionHeatmap::IsEnabled() || UpdatedPrimitive == nullptr) { return; }
+
+	// Find anything we're touching, using a slightly inflated collision shape
+	const UPrimitiveComponent* Contact = nullptr;
+
+	TArray<FOverlapResult> Overlaps;
+	FCollisionQueryParams Params = FCollisionQueryParams(FName(TEXT("NTCorrectionContact")), false, GetOwner());
+	if (GetWorld()->OverlapMultiByChannel(Overlaps, UpdatedPrimitive->GetComponentLocation(), UpdatedPrimitive->GetComponentQuat(), UpdatedPrimitive->GetCollisionObjectType(), UpdatedPrimitive->GetCollisionShape(2.f), Params))
+	{
+		for (const FOverlapResult& Overlap : Overlaps)
+		{
+			if (Overlap.GetComponent() != nullptr && Overlap.bBlockingHit)
+			{
+				Contact = Overlap.GetComponent();
+				break;
+			}
+		}
+	}
+
+	const float Error = FVector::Dist(InServerData.Location, InClientData.Location);
+	FNTGame_CorrectionHeatmap::Get().RecordCorrection(InServerData.Location, Error, Contact);
+}
+
 void UNTGame_MovementComponent::Client_DrawMoveBuffer(const float DeltaTime, const FColor& InColour)
 {
 	if (!bDrawDebug) { return; }
@@ -12,8 +12,11 @@
 ///////////////////
 
 const int32 FNetworkPredictionData_Client_Physics::MaxSavedMoves = 96;
-const int32 FNetworkPredictionData_Client_Physics::MaxFreeMoves = 32;
+const int32 FNetworkPredictionData_Client_Physics::MinSavedMoves = 16;
+const int32 FNTGame_SavedMovePool::MaxFreeMoves = 256;
 const float FNetworkPredictionData_Client_Physics::MaxMoveDeltaTime = 0.125f;	// AGameNetworkManager::MaxMoveDeltaTime
+const float FRepPawnMoveCorrection::MaxDelta = 300.f;							// Fits SerializePackedVector<100, 16>
+const float FRepPawnMoveCorrection::RotationQuantum = 0.01f;					// SerializePackedVector<100, 16> steps
 
 ///////////////////////////////////
 ///// Simplified Network Data /////
@@ -21,29 +24,20 @@ const float FNetworkPredictionData_Client_Physics::MaxMoveDeltaTime = 0.125f;	//
 
 void FSavedPhysicsMove::Clear()
 {
-	StartMoveData = FRepPawnMoveData();
 	EndMoveData = FRepPawnMoveData();
 	MoveInput = FRepPlayerInput();
 	MoveTimestamp = 0.f;
 	MoveDeltaTime = 0.f;
+	AccelDeltaTime = 0.f;
+	NumSubsteps = 1;
 	bForceNoCombine = false;
 	bHasInvalidTimeStampWhenStampsReset = false;
-}
-
-void FSavedPhysicsMove::PreUpdate(const UNTGame_MovementComponent* InComponent)
-{
-	StartMoveData.Location = InComponent->UpdatedPrimitive->GetComponentLocation();
-	StartMoveData.Rotation = InComponent->UpdatedPrimitive->GetComponentQuat();
-	StartMoveData.LinearVelocity = InComponent->UpdatedPrimitive->GetPhysicsLinearVelocity();
-	StartMoveData.AngularVelocity = InComponent->UpdatedPrimitive->GetPhysicsAngularVelocity();
+	bHadContact = false;
 }
 
 void FSavedPhysicsMove::PostUpdate(const UNTGame_MovementComponent* InComponent)
 {
-	EndMoveData.Location = InComponent->UpdatedPrimitive->GetComponentLocation();
-	EndMoveData.Rotation = InComponent->UpdatedPrimitive->GetComponentQuat();
-	EndMoveData.LinearVelocity = InComponent->UpdatedPrimitive->GetPhysicsLinearVelocity();
-	EndMoveData.AngularVelocity = InComponent->UpdatedPrimitive->GetPhysicsAngularVelocity();
+	EndMoveData = InComponent->GetCurrentMoveData();
 }
 
 bool FSavedPhysicsMove::IsImportantMove(const FSavedPhysicsMovePtr& LastAckedMove) const
@@ -58,16 +52,127 @@ bool FSavedPhysicsMove::CanCombineWith(const FSavedPhysicsMovePtr& OtherPendingM
 	return MoveInput == OtherPendingMove->MoveInput;
 }
 
+/////////////////////
+///// Move Pool /////
+/////////////////////
+
+static TMap<const UWorld*, TSharedRef<FNTGame_SavedMovePool>> GWorldMovePools;
+
+TSharedRef<FNTGame_SavedMovePool> FNTGame_SavedMovePool::Get(const UWorld* InWorld)
+{
+	checkSlow(IsInGameThread());
+
+	if (TSharedRef<FNTGame_SavedMovePool>* ExistingPool = GWorldMovePools.Find(InWorld))
+	{
+		return *ExistingPool;
+	}
+
+	static FDelegateHandle CleanupHandle;
+	if (!CleanupHandle.IsValid())
+	{
+		CleanupHandle = FWorldDelegates::OnWorldCleanup.AddStatic(&FNTGame_SavedMovePool::OnWorldCleanup);
+	}
+
+	return GWorldMovePools.Add(InWorld, MakeShareable(new FNTGame_SavedMovePool()));
+}
+
+void FNTGame_SavedMovePool::OnWorldCleanup(UWorld* InWorld, bool bSessionEnded, bool bCleanupResources)
+{
+	// Prediction data that outlives the world keeps its own reference
+	GWorldMovePools.Remove(InWorld);
+}
+
+FNTGame_SavedMovePool::~FNTGame_SavedMovePool()
+{
+	for (FSavedPhysicsMove* FreeMove : FreeMoves)
+	{
+		DestroyMove(FreeMove);
+	}
+
+	FreeMoves.Empty();
+}
+
+FSavedPhysicsMove* FNTGame_SavedMovePool::AllocateMove()
+{
+	// Cache line aligned, so no two moves share one
+	void* MoveMemory = FMemory::Malloc(sizeof(FSavedPhysicsMove), PLATFORM_CACHE_LINE_SIZE);
+	return new (MoveMemory) FSavedPhysicsMove();
+}
+
+void FNTGame_SavedMovePool::DestroyMove(FSavedPhysicsMove* InMove)
+{
+	InMove->~FSavedPhysicsMove();
+	FMemory::Free(InMove);
+}
+
+FSavedPhysicsMovePtr FNTGame_SavedMovePool::Acquire()
+{
+	checkSlow(IsInGameThread());
+
+	FSavedPhysicsMove* NewMove = FreeMoves.Num() > 0 ? FreeMoves.Pop(false) : AllocateMove();
+	NewMove->Clear();
+
+	// The move comes back to us once nothing references it. If we've gone by then, it's just freed.
+	TWeakPtr<FNTGame_SavedMovePool> WeakPool = AsShared();
+	return MakeShareable(NewMove, [WeakPool](FSavedPhysicsMove* InMove)
+	{
+		TSharedPtr<FNTGame_SavedMovePool> Pool = WeakPool.Pin();
+		if (Pool.IsValid())
+		{
+			Pool->ReturnMove(InMove);
+		}
+		else
+		{
+			DestroyMove(InMove);
+		}
+	});
+}
+
+void FNTGame_SavedMovePool::ReturnMove(FSavedPhysicsMove* InMove)
+{
+	checkSlow(IsInGameThread());
+
+	if (FreeMoves.Num() < MaxFreeMoves)
+	{
+		FreeMoves.Push(InMove);
+	}
+	else
+	{
+		DestroyMove(InMove);
+	}
+}
+
 //////////////////////////////////
 ///// Simplified Client Data /////
 //////////////////////////////////
 
-FNetworkPredictionData_Client_Physics::FNetworkPredictionData_Client_Physics()
+FNetworkPredictionData_Client_Physics::FNetworkPredictionData_Client_Physics(const UWorld* InWorld)
 	: ClientUpdateTime(0.f)
 	, CurrentTimeStamp(0.f)
+	, TimeDilation(1.f)
+	, bLastMoveAtRest(false)
+	, SmoothedRTT(0.f)
+	, RTTVariance(0.f)
+	, AverageMoveDeltaTime(1.f / 60.f)
+	, SavedMoveLimit(MaxSavedMoves)
+	, NumCorrections(0)
+	, NumMovesReplayed(0)
+	, LastCorrectionId(0)
 	, PendingMove(NULL)
 	, LastAckedMove(NULL)
-{}
+{
+	ASSERTV(InWorld != nullptr, TEXT("Invalid World For Client Data"));
+	MovePool = FNTGame_SavedMovePool::Get(InWorld);
+}
+
+FNetworkPredictionData_Client_Physics::~FNetworkPredictionData_Client_Physics()
+{
+	// Moves go back to the pool as they're released, so let go of them while we still hold it
+	SavedMoves.Empty();
+	PendingMove = NULL;
+	LastAckedMove = NULL;
+	CurrentMove = NULL;
+}
 
 int32 FNetworkPredictionData_Client_Physics::GetMoveIndexFromTimeStamp(const float TimeStamp) const
 {
@@ -97,6 +202,11 @@ void FNetworkPredictionData_Client_Physics::AcknowledgeMove(const int32 AckMoveI
 	if (AckMoveIndex != INDEX_NONE)
 	{
 		const FSavedPhysicsMovePtr& AckedMove = SavedMoves[AckMoveIndex];
+		if (!AckedMove->bHasInvalidTimeStampWhenStampsReset)
+		{
+			UpdateRoundTripTime(CurrentTimeStamp - AckedMove->MoveTimestamp);
+		}
+
 		if (LastAckedMove.IsValid())
 		{
 			FreeMove(LastAckedMove);
@@ -118,13 +228,7 @@ void FNetworkPredictionData_Client_Physics::FreeMove(const FSavedPhysicsMovePtr&
 {
 	if (FreedMove.IsValid())
 	{
-		// Only keep a pool of a limited number of moves
-		if (FreeMoves.Num() < MaxFreeMoves)
-		{
-			FreeMoves.Push(FreedMove);
-		}
-
-		// Shouldn't keep a reference to the move on the free list
+		// The move goes back to the pool once the last reference is gone, so drop ours
 		if (PendingMove == FreedMove)
 		{
 			PendingMove = NULL;
@@ -139,33 +243,22 @@ void FNetworkPredictionData_Client_Physics::FreeMove(const FSavedPhysicsMovePtr&
 
 FSavedPhysicsMovePtr FNetworkPredictionData_Client_Physics::CreateSavedMove()
 {
-	if (SavedMoves.Num() >= MaxSavedMoves)
+	if (SavedMoves.Num() >= SavedMoveLimit)
 	{
 		UE_LOG(LogNTGameMovement, Warning, TEXT("CreateSavedMove: Hit limit of %d saved moves (timing out or very bad ping?)"), SavedMoves.Num());
-		// Free all saved moves
-		for (int32 Idx = 0; Idx < SavedMoves.Num(); Idx++)
+		// Only drop the oldest moves, acks for them will be ignored
+		const int32 NumToDrop = SavedMoves.Num() - SavedMoveLimit + 1;
+		for (int32 Idx = 0; Idx < NumToDrop; Idx++)
 		{
 			FreeMove(SavedMoves[Idx]);
 		}
 
-		SavedMoves.Reset();
+		SavedMoves.RemoveAt(0, NumToDrop);
 	}
 
-	if (FreeMoves.Num() == 0)
-	{
-		// No free moves, allocate a new one
-		FSavedPhysicsMovePtr NewMove = AllocateNewMove();
-		ASSERTV_WR(NewMove.IsValid(), NULL, TEXT("CreateSavedMove: AllocateNewMove unable to create a new move!"));
-		NewMove->Clear();
-		return NewMove;
-	}
-	else
-	{
-		// Pull from first free pool
-		FSavedPhysicsMovePtr FirstFree = FreeMoves.Pop();
-		FirstFree->Clear();
-		return FirstFree;
-	}
+	FSavedPhysicsMovePtr NewMove = MovePool->Acquire();
+	ASSERTV_WR(NewMove.IsValid(), NULL, TEXT("CreateSavedMove: Unable to create a new move!"));
+	return NewMove;
 }
 
 float FNetworkPredictionData_Client_Physics::UpdateTimeStampAndDeltaTime(const float InDeltaTime, const float MinTimeBetweenResets)
@@ -190,9 +283,12 @@ float FNetworkPredictionData_Client_Physics::UpdateTimeStampAndDeltaTime(const f
 		}
 	}
 
-	// Update time stamp
-	CurrentTimeStamp += InDeltaTime;
-	float ClientDeltaTime = InDeltaTime;
+	AverageMoveDeltaTime = FMath::Lerp(AverageMoveDeltaTime, InDeltaTime, 0.05f);
+
+	// Update time stamp, dilated by the server's request
+	const float DilatedDeltaTime = InDeltaTime * TimeDilation;
+	CurrentTimeStamp += DilatedDeltaTime;
+	float ClientDeltaTime = DilatedDeltaTime;
 
 	// Server uses timestamps to derive delta time, which introduces some rounding errors.
 	// Make sure we do the same, so that MoveAutonomous uses the same input and is deterministic!
@@ -210,6 +306,34 @@ float FNetworkPredictionData_Client_Physics::UpdateTimeStampAndDeltaTime(const f
 	return FMath::Min(ClientDeltaTime, MaxMoveDeltaTime);
 }
 
+void FNetworkPredictionData_Client_Physics::UpdateRoundTripTime(const float RTTSample)
+{
+	if (RTTSample <= 0.f) { return; }
+
+	// Standard smoothed RTT / variance estimator (RFC 6298)
+	if (SmoothedRTT == 0.f)
+	{
+		SmoothedRTT = RTTSample;
+		RTTVariance = RTTSample * 0.5f;
+	}
+	else
+	{
+		RTTVariance = (0.75f * RTTVariance) + (0.25f * FMath::Abs(SmoothedRTT - RTTSample));
+		SmoothedRTT = (0.875f * SmoothedRTT) + (0.125f * RTTSample);
+	}
+
+	UpdateMoveLimits();
+}
+
+void FNetworkPredictionData_Client_Physics::UpdateMoveLimits()
+{
+	// Keep enough history to cover a pessimistic round trip, plus some headroom
+	const float HistoryTime = SmoothedRTT + (4.f * RTTVariance);
+	const int32 NeededMoves = FMath::CeilToInt(HistoryTime / FMath::Max(AverageMoveDeltaTime, KINDA_SMALL_NUMBER)) * 3 / 2;
+
+	SavedMoveLimit = FMath::Clamp(NeededMoves, MinSavedMoves, MaxSavedMoves);
+}
+
 //////////////////////////////////
 ///// Simplified Server Data /////
 //////////////////////////////////
@@ -219,17 +343,40 @@ FNetworkPredictionData_Server_Physics::FNetworkPredictionData_Server_Physics(con
 	, LastUpdateTime(0.f)
 	, ServerTimeStampLastServerMove(0.f)
 	, bForceClientUpdate(false)
+	, bClientAtRest(false)
 	, LifetimeRawTimeDiscrepancy(0.f)
 	, TimeDiscrepancy(0.f)
 	, bResolvingTimeDiscrepancy(false)
 	, TimeDiscrepancyResolutionMoveDeltaOverride(0.f)
 	, TimeDiscrepancyAccumulatedClientDeltasSinceLastServerTick(0.f)
 	, WorldCreationTime(0.f)
+	, LastClientInput(FRepPlayerInput())
+	, NumFutureInputsUsed(0)
+	, ExtrapolatedTime(0.f)
+	, ClientTimeLead(0.f)
+	, ClientTimeJitter(0.f)
+	, LastMoveArrivalTime(0.0)
+	, LastTimeDilationUpdateTime(0.f)
+	, AccumulatedClientError(0.f)
+	, PendingCorrectionId(0)
+	, ClientAckedCorrectionId(0)
+	, PendingCorrectionTime(0.f)
+	, NumGoodMoves(0)
+	, NumBadMoves(0)
 	, CurrentlyProcessingClientMove(NULL)
 {
 	ASSERTV(InWorld != nullptr, TEXT("Invalid World For Server Data"))
 	WorldCreationTime = InWorld->GetTimeSeconds();
 	ServerTimeStamp = InWorld->GetTimeSeconds();		// Prevents 'Force Update' being called when initially respawned
+
+	MovePool = FNTGame_SavedMovePool::Get(InWorld);
+	ProcessingMove = MovePool->Acquire();
+}
+
+FNetworkPredictionData_Server_Physics::~FNetworkPredictionData_Server_Physics()
+{
+	CurrentlyProcessingClientMove = NULL;
+	ProcessingMove = NULL;
 }
 
 float FNetworkPredictionData_Server_Physics::GetServerMoveDeltaTime(const float ClientTimeStamp) const
@@ -252,11 +399,14 @@ float FNetworkPredictionData_Server_Physics::GetBaseServerMoveDeltaTime(const fl
 
 FSavedPhysicsMovePtr FNetworkPredictionData_Server_Physics::CreateProcessingMove(const float MoveTimeStamp, const float AccelDelta, const FRepPlayerInput& ClientInput, const FRepPawnMoveData& ClientEndData)
 {
-	CurrentlyProcessingClientMove = FSavedPhysicsMovePtr(new FSavedPhysicsMove());
-	ASSERTV_WR(CurrentlyProcessingClientMove.IsValid(), NULL, TEXT("Can't Create Processing Move"));
+	ASSERTV_WR(ProcessingMove.IsValid(), NULL, TEXT("Can't Create Processing Move"));
+
+	ProcessingMove->Clear();
+	CurrentlyProcessingClientMove = ProcessingMove;
 	
-	CurrentlyProcessingClientMove->StartMoveData = ClientEndData;
+	ClientEndMoveData = ClientEndData;
 	CurrentlyProcessingClientMove->MoveDeltaTime = AccelDelta;
+	CurrentlyProcessingClientMove->AccelDeltaTime = AccelDelta;
 	CurrentlyProcessingClientMove->MoveTimestamp = MoveTimeStamp;
 	CurrentlyProcessingClientMove->MoveInput = ClientInput;
 
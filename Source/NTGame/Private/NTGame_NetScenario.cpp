@@ -0,0 +1,337 @@
+// Copyright (C) James Baxter 2017. All Rights Reserved.
+
+#include "NTGame.h"
+#include "NTGame_NetScenario.h"
+
+#include "NTGame_Benchmark.h"
+#include "NTGame_Pawn.h"
+#include "NTGame_MovementComponent.h"
+
+// Json
+#include "Serialization/JsonWriter.h"
+#include "Policies/PrettyJsonPrintPolicy.h"
+
+///////////////////////////
+///// Console Command /////
+///////////////////////////
+
+static void StartNTScenario(const TArray<FString>& Args, UWorld* World)
+{
+	if (World == nullptr) { return; }
+
+	const ANTGame_NetScenario* ScenarioCDO = GetDefault<ANTGame_NetScenario>();
+	if (Args.Num() == 0 || Args[0] == TEXT("list"))
+	{
+		for (const FNTGame_NetScenarioDef& Scenario : ScenarioCDO->Scenarios)
+		{
+			UE_LOG(LogNTGame, Display, TEXT("NT Scenario: %s (%d phases)"), *Scenario.Name, Scenario.Phases.Num());
+		}
+		return;
+	}
+
+	const bool bScriptedInput = Args.Contains(TEXT("bot"));
+	const bool bExitWhenDone = Args.Contains(TEXT("exit"));
+
+	FActorSpawnParameters SpawnInfo;
+	SpawnInfo.ObjectFlags |= RF_Transient;
+
+	ANTGame_NetScenario* Scenario = World->SpawnActor<ANTGame_NetScenario>(SpawnInfo);
+	ASSERTV(Scenario != nullptr, TEXT("Unable To Spawn Scenario"));
+
+	if (!Scenario->StartScenario(Args[0], bScriptedInput, bExitWhenDone))
+	{
+		Scenario->Destroy();
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs NTScenarioCommand(
+	TEXT("NT.Scenario"),
+	TEXT("Play back a network condition scenario from DefaultGame.ini and record corrections per phase. NT.Scenario <Name | list> [bot] [exit]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&StartNTScenario));
+
+////////////////////////
+///// Construction /////
+////////////////////////
+
+ANTGame_NetScenario::ANTGame_NetScenario(const FObjectInitializer& OI)
+	: Super(OI)
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = true;
+	PrimaryActorTick.bAllowTickOnDedicatedServer = true;
+	PrimaryActorTick.TickGroup = ETickingGroup::TG_PrePhysics;
+
+	bReplicates = false;
+
+	PhaseIndex = INDEX_NONE;
+	PhaseTime = 0.f;
+	ScriptTime = 0.f;
+	bScriptedInput = false;
+	bExitWhenDone = false;
+	bRunning = false;
+}
+
+void ANTGame_NetScenario::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (bRunning)
+	{
+		ResetPacketSettings();
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+////////////////////
+///// Scenario /////
+////////////////////
+
+bool ANTGame_NetScenario::StartScenario(const FString& InName, const bool bInScriptedInput, const bool bInExitWhenDone)
+{
+	const FNTGame_NetScenarioDef* FoundScenario = Scenarios.FindByPredicate([&InName](const FNTGame_NetScenarioDef& Scenario) { return Scenario.Name == InName; });
+	if (FoundScenario == nullptr || FoundScenario->Phases.Num() == 0)
+	{
+		UE_LOG(LogNTGame, Warning, TEXT("NT Scenario: Unknown or empty scenario %s"), *InName);
+		return false;
+	}
+
+	if (GetWorld()->GetNetDriver() == nullptr)
+	{
+		UE_LOG(LogNTGame, Warning, TEXT("NT Scenario: %s requires a network session"), *InName);
+		return false;
+	}
+
+	ActiveScenario = *FoundScenario;
+	bScriptedInput = bInScriptedInput;
+	bExitWhenDone = bInExitWhenDone;
+	bRunning = true;
+	SavedPacketSettings = GetWorld()->GetNetDriver()->PacketSimulationSettings;
+
+	UE_LOG(LogNTGame, Log, TEXT("Starting NT Scenario %s: %d phases"), *ActiveScenario.Name, ActiveScenario.Phases.Num());
+
+	Results.Reset();
+	BeginPhase(0);
+	return true;
+}
+
+void ANTGame_NetScenario::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	if (!bRunning || !ActiveScenario.Phases.IsValidIndex(PhaseIndex)) { return; }
+
+	ScriptTime += DeltaSeconds;
+	PhaseTime += DeltaSeconds;
+
+	if (bScriptedInput)
+	{
+		const ANTGame_Pawn* LocalPawn = GetLocalPawn();
+		if (LocalPawn && LocalPawn->GetPhysicsMovement())
+		{
+			ANTGame_Benchmark::DriveScriptedInput(LocalPawn->GetPhysicsMovement(), ScriptTime);
+		}
+	}
+
+	const FNTGame_NetProfilePhase& Phase = ActiveScenario.Phases[PhaseIndex];
+	ApplyPhaseSettings(Phase, FMath::Clamp(PhaseTime / FMath::Max(Phase.Duration, KINDA_SMALL_NUMBER), 0.f, 1.f));
+
+	FNTGame_NetScenarioResult& Result = Results.Last();
+	SamplePhase(Result);
+	Result.Duration += DeltaSeconds;
+
+	if (PhaseTime >= Phase.Duration)
+	{
+		EndPhase();
+
+		if (ActiveScenario.Phases.IsValidIndex(PhaseIndex + 1))
+		{
+			BeginPhase(PhaseIndex + 1);
+		}
+		else
+		{
+			FinishScenario();
+		}
+	}
+}
+
+void ANTGame_NetScenario::BeginPhase(const int32 InPhaseIndex)
+{
+	PhaseIndex = InPhaseIndex;
+	PhaseTime = 0.f;
+
+	const FNTGame_NetProfilePhase& Phase = ActiveScenario.Phases[PhaseIndex];
+	ApplyPhaseSettings(Phase, 0.f);
+
+	FNTGame_NetScenarioResult NewResult = FNTGame_NetScenarioResult();
+	NewResult.Name = Phase.Name;
+	NewResult.StartFrame = GFrameCounter;
+	GetMoveTotals(NewResult.StartCorrections, NewResult.StartMovesReplayed, NewResult.StartMovementCycles);
+	Results.Add(NewResult);
+}
+
+void ANTGame_NetScenario::EndPhase()
+{
+	FNTGame_NetScenarioResult& Result = Results.Last();
+
+	uint32 TotalCorrections = 0;
+	uint32 TotalMovesReplayed = 0;
+	uint64 TotalMovementCycles = 0;
+	GetMoveTotals(TotalCorrections, TotalMovesReplayed, TotalMovementCycles);
+
+	const uint64 NumFrames = FMath::Max<uint64>(GFrameCounter - Result.StartFrame, 1);
+	Result.Corrections = TotalCorrections - Result.StartCorrections;
+	Result.MovesReplayed = TotalMovesReplayed - Result.StartMovesReplayed;
+	Result.MovementMS = (float)((TotalMovementCycles - Result.StartMovementCycles) * FPlatformTime::GetSecondsPerCycle() * 1000.0 / NumFrames);
+
+	UE_LOG(LogNTGame, Log, TEXT("NT Scenario %s: Phase %s, %u corrections, %u moves replayed, %f ms movement per frame"), *ActiveScenario.Name, *Result.Name, Result.Corrections, Result.MovesReplayed, Result.MovementMS);
+}
+
+void ANTGame_NetScenario::FinishScenario()
+{
+	bRunning = false;
+
+	ResetPacketSettings();
+	WriteResults();
+
+	if (bExitWhenDone)
+	{
+		FPlatformMisc::RequestExit(false);
+	}
+	else
+	{
+		Destroy();
+	}
+}
+
+/////////////////////////////
+///// Packet Simulation /////
+/////////////////////////////
+
+void ANTGame_NetScenario::ApplyPhaseSettings(const FNTGame_NetProfilePhase& InPhase, const float InAlpha) const
+{
+	UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	ASSERTV(NetDriver != nullptr, TEXT("Invalid Net Driver"));
+
+	// Packet simulation only affects outgoing packets, so each side simulates its own upstream
+	FPacketSimulationSettings& Settings = NetDriver->PacketSimulationSettings;
+	Settings.PktLag = InPhase.PktLagEnd >= 0 ? FMath::RoundToInt(FMath::Lerp((float)InPhase.PktLag, (float)InPhase.PktLagEnd, InAlpha)) : InPhase.PktLag;
+	Settings.PktLagVariance = InPhase.PktLagVariance;
+	Settings.PktLoss = InPhase.PktLoss;
+	Settings.PktDup = InPhase.PktDup;
+	Settings.PktOrder = InPhase.bPktOrder ? 1 : 0;
+}
+
+void ANTGame_NetScenario::ResetPacketSettings() const
+{
+	UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	ASSERTV(NetDriver != nullptr, TEXT("Invalid Net Driver"));
+
+	NetDriver->PacketSimulationSettings = SavedPacketSettings;
+}
+
+///////////////////
+///// Results /////
+///////////////////
+
+ANTGame_Pawn* ANTGame_NetScenario::GetLocalPawn() const
+{
+	const APlayerController* LocalPC = GetWorld()->GetFirstPlayerController();
+	return LocalPC ? Cast<ANTGame_Pawn>(LocalPC->GetPawn()) : nullptr;
+}
+
+void ANTGame_NetScenario::SamplePhase(FNTGame_NetScenarioResult& Result) const
+{
+	const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	ASSERTV(NetDriver != nullptr, TEXT("Invalid Net Driver"));
+
+	if (NetDriver->ServerConnection)
+	{
+		Result.TotalBytesIn += NetDriver->ServerConnection->InBytesPerSecond;
+		Result.TotalBytesOut += NetDriver->ServerConnection->OutBytesPerSecond;
+	}
+
+	for (const UNetConnection* Connection : NetDriver->ClientConnections)
+	{
+		if (Connection == nullptr) { continue; }
+
+		Result.TotalBytesIn += Connection->InBytesPerSecond;
+		Result.TotalBytesOut += Connection->OutBytesPerSecond;
+	}
+
+	Result.NumSamples++;
+}
+
+void ANTGame_NetScenario::GetMoveTotals(uint32& OutCorrections, uint32& OutMovesReplayed, uint64& OutMovementCycles) const
+{
+	OutCorrections = 0;
+	OutMovesReplayed = 0;
+	OutMovementCycles = 0;
+
+	for (TActorIterator<ANTGame_Pawn> PawnItr(GetWorld()); PawnItr; ++PawnItr)
+	{
+		const UNTGame_MovementComponent* PawnMovement = PawnItr->GetPhysicsMovement();
+		if (PawnMovement == nullptr) { continue; }
+
+		if (GetNetMode() == NM_Client)
+		{
+			// Only the local pawn predicts and gets corrected
+			if (!PawnMovement->HasPredictionData_Client()) { continue; }
+
+			const FNetworkPredictionData_Client_Physics* ClientData = static_cast<const FNetworkPredictionData_Client_Physics*>(PawnMovement->GetPredictionData_Client());
+			OutCorrections += ClientData->NumCorrections;
+			OutMovesReplayed += ClientData->NumMovesReplayed;
+		}
+		else
+		{
+			if (!PawnMovement->HasPredictionData_Server()) { continue; }
+
+			const FNetworkPredictionData_Server_Physics* ServerData = static_cast<const FNetworkPredictionData_Server_Physics*>(PawnMovement->GetPredictionData_Server());
+			OutCorrections += ServerData->NumBadMoves;
+		}
+
+		OutMovementCycles += PawnMovement->GetMovementCycles();
+	}
+}
+
+void ANTGame_NetScenario::WriteResults() const
+{
+	FString Output;
+	TSharedRef<TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>::Create(&Output);
+
+	Writer->WriteObjectStart();
+	Writer->WriteValue(TEXT("scenario"), ActiveScenario.Name);
+	Writer->WriteValue(TEXT("map"), GetWorld()->GetMapName());
+	Writer->WriteValue(TEXT("netMode"), GetNetMode() == NM_Client ? TEXT("client") : TEXT("server"));
+
+	Writer->WriteArrayStart(TEXT("phases"));
+	for (const FNTGame_NetScenarioResult& Result : Results)
+	{
+		const float Samples = (float)FMath::Max(Result.NumSamples, 1);
+		const float Duration = FMath::Max(Result.Duration, KINDA_SMALL_NUMBER);
+
+		Writer->WriteObjectStart();
+		Writer->WriteValue(TEXT("name"), Result.Name);
+		Writer->WriteValue(TEXT("seconds"), Result.Duration);
+		Writer->WriteValue(TEXT("corrections"), (int32)Result.Corrections);
+		Writer->WriteValue(TEXT("correctionsPerSecond"), (float)Result.Corrections / Duration);
+		Writer->WriteValue(TEXT("movesReplayed"), (int32)Result.MovesReplayed);
+		Writer->WriteValue(TEXT("movesPerReplay"), Result.Corrections > 0 ? (float)Result.MovesReplayed / (float)Result.Corrections : 0.f);
+		Writer->WriteValue(TEXT("movementMsPerFrame"), Result.MovementMS);
+		Writer->WriteValue(TEXT("bytesIn"), Result.TotalBytesIn / Samples);
+		Writer->WriteValue(TEXT("bytesOut"), Result.TotalBytesOut / Samples);
+		Writer->WriteObjectEnd();
+	}
+	Writer->WriteArrayEnd();
+
+	Writer->WriteObjectEnd();
+	Writer->Close();
+
+	const FString OutputFilename = FString::Printf(TEXT("%sBenchmarks/NTScenario-%s-%s.json"), *FPaths::GameSavedDir(), *ActiveScenario.Name, *FDateTime::Now().ToString());
+	if (FFileHelper::SaveStringToFile(Output, *OutputFilename))
+	{
+		UE_LOG(LogNTGame, Log, TEXT("NT Scenario results written to %s"), *OutputFilename);
+	}
+	else
+	{
+		UE_LOG(LogNTGame, Error, TEXT("NT Scenario unable to write results to %s"), *OutputFilename);
+	}
+}
@@ -0,0 +1,243 @@
+// Copyright (C) James Baxter 2017. All Rights Reserved.
+
+#include "NTGame.h"
+#include "NTGame_MovementTypes.h"
+#include "NTGame_MovementComponent.h"
+
+/////////////////////////////
+///// Console Variables /////
+/////////////////////////////
+
+static TAutoConsoleVariable<int32> CVarNTBandwidthTelemetry(
+	TEXT("NT.BandwidthTelemetry"),
+	0,
+	TEXT("Record per-RPC and per-field bits written by movement RPC's. Use NT.DumpBandwidth to export.\n")
+	TEXT("0: Disabled, 1: Enabled"),
+	ECVF_Default);
+
+///////////////////////////////
+///// Bandwidth Telemetry /////
+///////////////////////////////
+
+bool FNTGame_BandwidthStats::IsEnabled()
+{
+	return CVarNTBandwidthTelemetry.GetValueOnGameThread() > 0;
+}
+
+const TCHAR* FNTGame_BandwidthStats::GetRPCName(const ENTGame_MoveRPC InRPC)
+{
+	switch (InRPC)
+	{
+		case ENTGame_MoveRPC::ServerMove:			return TEXT("ServerMove");
+		case ENTGame_MoveRPC::ClientAckGoodMove:	return TEXT("ClientAckGoodMove");
+		case ENTGame_MoveRPC::ClientAckBadMove:		return TEXT("ClientAckBadMove");
+		case ENTGame_MoveRPC::ClientUpdateMoveLead:	return TEXT("ClientUpdateMoveLead");
+		default:									return TEXT("Unknown");
+	}
+}
+
+void FNTGame_BandwidthStats::Reset(const float InStartTime)
+{
+	for (int32 Idx = 0; Idx < (int32)ENTGame_MoveRPC::MAX; Idx++)
+	{
+		RPCs[Idx] = FNTGame_RPCBandwidth();
+	}
+
+	StartTime = InStartTime;
+}
+
+void FNTGame_BandwidthStats::RecordServerMove(const FRepPlayerInput& InInput, const FRepPlayerInput* InLatestInput, const FRepPawnMoveData& InEndMoveData)
+{
+	if (!IsEnabled()) { return; }
+
+	FNTGame_RPCBandwidth& RPC = RPCs[(uint8)ENTGame_MoveRPC::ServerMove];
+	RPC.NumCalls++;
+
+	RecordTimeStamp(RPC);
+	RecordInput(RPC, InInput);
+	if (InLatestInput)
+	{
+		RecordInput(RPC, *InLatestInput);
+	}
+	RecordMoveData(RPC, InEndMoveData);
+
+	// Correction Id
+	RPC.OtherBits += 8;
+	RPC.TotalBits += 8;
+}
+
+void FNTGame_BandwidthStats::RecordAckGoodMove()
+{
+	if (!IsEnabled()) { return; }
+
+	FNTGame_RPCBandwidth& RPC = RPCs[(uint8)ENTGame_MoveRPC::ClientAckGoodMove];
+	RPC.NumCalls++;
+
+	RecordTimeStamp(RPC);
+}
+
+void FNTGame_BandwidthStats::RecordAckBadMove(const FRepPawnMoveCorrection& InCorrection, const FRepPawnBodySnapshot& InServerEndBodies)
+{
+	if (!IsEnabled()) { return; }
+
+	FNTGame_RPCBandwidth& RPC = RPCs[(uint8)ENTGame_MoveRPC::ClientAckBadMove];
+	RPC.NumCalls++;
+
+	RecordTimeStamp(RPC);
+	if (InCorrection.bIsDelta)
+	{
+		RecordMoveDelta(RPC, InCorrection);
+	}
+	else
+	{
+		RecordMoveData(RPC, InCorrection.MoveData);
+	}
+
+	// Extra bodies are counted as a whole, along with the correction Id and delta flag
+	FRepPawnBodySnapshot BodiesCopy = InServerEndBodies;
+	FBitWriter Writer(256, true);
+	bool bSuccess = true;
+	BodiesCopy.NetSerialize(Writer, nullptr, bSuccess);
+
+	RPC.OtherBits += Writer.GetNumBits() + 9;
+	RPC.TotalBits += Writer.GetNumBits() + 9;
+}
+
+void FNTGame_BandwidthStats::RecordMoveLead()
+{
+	if (!IsEnabled()) { return; }
+
+	FNTGame_RPCBandwidth& RPC = RPCs[(uint8)ENTGame_MoveRPC::ClientUpdateMoveLead];
+	RPC.NumCalls++;
+	RPC.OtherBits += 8;
+	RPC.TotalBits += 8;
+}
+
+void FNTGame_BandwidthStats::RecordTimeStamp(FNTGame_RPCBandwidth& InRPC)
+{
+	const uint32 TimeStampBits = sizeof(float) * 8;
+	InRPC.TimeStampBits += TimeStampBits;
+	InRPC.TotalBits += TimeStampBits;
+}
+
+void FNTGame_BandwidthStats::RecordInput(FNTGame_RPCBandwidth& InRPC, const FRepPlayerInput& InInput)
+{
+	// Serialize into a scratch writer, so the count always matches NetSerialize
+	FRepPlayerInput InputCopy = InInput;
+	FBitWriter Writer(64, true);
+	bool bSuccess = true;
+	InputCopy.NetSerialize(Writer, nullptr, bSuccess);
+
+	InRPC.InputBits += Writer.GetNumBits();
+	InRPC.TotalBits += Writer.GetNumBits();
+}
+
+/* Bits written by one of a struct's field serializers */
+template<typename SerializeFunc>
+static uint32 MeasureFieldBits(SerializeFunc InSerialize)
+{
+	FBitWriter Writer(128, true);
+	InSerialize(Writer);
+	return Writer.GetNumBits();
+}
+
+void FNTGame_BandwidthStats::RecordMoveData(FNTGame_RPCBandwidth& InRPC, const FRepPawnMoveData& InMoveData)
+{
+	// Measured with the struct's own field serializers, so the counts always match NetSerialize
+	FRepPawnMoveData DataCopy = InMoveData;
+
+	const uint32 LocationBits = MeasureFieldBits([&DataCopy](FArchive& Ar) { DataCopy.SerializeLocation(Ar); });
+	const uint32 RotationBits = MeasureFieldBits([&DataCopy](FArchive& Ar) { DataCopy.SerializeRotation(Ar); });
+	const uint32 LinearBits = MeasureFieldBits([&DataCopy](FArchive& Ar) { DataCopy.SerializeLinearVelocity(Ar); });
+	const uint32 AngularBits = MeasureFieldBits([&DataCopy](FArchive& Ar) { DataCopy.SerializeAngularVelocity(Ar); });
+
+	InRPC.LocationBits += LocationBits;
+	InRPC.RotationBits += RotationBits;
+	InRPC.LinearVelocityBits += LinearBits;
+	InRPC.AngularVelocityBits += AngularBits;
+	InRPC.TotalBits += LocationBits + RotationBits + LinearBits + AngularBits;
+}
+
+void FNTGame_BandwidthStats::RecordMoveDelta(FNTGame_RPCBandwidth& InRPC, const FRepPawnMoveCorrection& InCorrection)
+{
+	FRepPawnMoveCorrection CorrectionCopy = InCorrection;
+
+	const uint32 LocationBits = MeasureFieldBits([&CorrectionCopy](FArchive& Ar) { CorrectionCopy.SerializeDeltaLocation(Ar); });
+	const uint32 RotationBits = MeasureFieldBits([&CorrectionCopy](FArchive& Ar) { CorrectionCopy.SerializeDeltaRotation(Ar); });
+	const uint32 LinearBits = MeasureFieldBits([&CorrectionCopy](FArchive& Ar) { CorrectionCopy.SerializeDeltaLinearVelocity(Ar); });
+	const uint32 AngularBits = MeasureFieldBits([&CorrectionCopy](FArchive& Ar) { CorrectionCopy.SerializeDeltaAngularVelocity(Ar); });
+
+	InRPC.LocationBits += LocationBits;
+	InRPC.RotationBits += RotationBits;
+	InRPC.LinearVelocityBits += LinearBits;
+	InRPC.AngularVelocityBits += AngularBits;
+	InRPC.TotalBits += LocationBits + RotationBits + LinearBits + AngularBits;
+}
+
+//////////////////////
+///// CSV Export /////
+//////////////////////
+
+static void DumpNTBandwidth(const TArray<FString>& Args, UWorld* World)
+{
+	if (World == nullptr) { return; }
+
+	const bool bReset = Args.Contains(TEXT("reset"));
+	const float WorldTime = World->GetTimeSeconds();
+
+	FString Output = TEXT("Owner,Connection,RPC,Calls,TotalBits,BitsPerCall,BitsPerSecond,TimeStampBits,InputBits,LocationBits,RotationBits,LinearVelocityBits,AngularVelocityBits,OtherBits\n");
+
+	for (TObjectIterator<UNTGame_MovementComponent> CompItr; CompItr; ++CompItr)
+	{
+		UNTGame_MovementComponent* MoveComp = *CompItr;
+		if (MoveComp == nullptr || MoveComp->GetWorld() != World || MoveComp->GetOwner() == nullptr) { continue; }
+
+		const FNTGame_BandwidthStats& Stats = MoveComp->GetBandwidthStats();
+		const float Elapsed = FMath::Max(WorldTime - Stats.StartTime, KINDA_SMALL_NUMBER);
+
+		const UNetConnection* Connection = MoveComp->GetOwner()->GetNetConnection();
+		const FString ConnectionName = Connection ? Connection->LowLevelGetRemoteAddress() : FString(TEXT("None"));
+
+		for (int32 Idx = 0; Idx < (int32)ENTGame_MoveRPC::MAX; Idx++)
+		{
+			const FNTGame_RPCBandwidth& RPC = Stats.RPCs[Idx];
+			if (RPC.NumCalls == 0) { continue; }
+
+			Output += FString::Printf(TEXT("%s,%s,%s,%u,%llu,%f,%f,%llu,%llu,%llu,%llu,%llu,%llu,%llu\n"),
+				*MoveComp->GetOwner()->GetName(),
+				*ConnectionName,
+				FNTGame_BandwidthStats::GetRPCName((ENTGame_MoveRPC)Idx),
+				RPC.NumCalls,
+				RPC.TotalBits,
+				(float)RPC.TotalBits / (float)RPC.NumCalls,
+				(float)RPC.TotalBits / Elapsed,
+				RPC.TimeStampBits,
+				RPC.InputBits,
+				RPC.LocationBits,
+				RPC.RotationBits,
+				RPC.LinearVelocityBits,
+				RPC.AngularVelocityBits,
+				RPC.OtherBits);
+		}
+
+		if (bReset)
+		{
+			MoveComp->ResetBandwidthStats();
+		}
+	}
+
+	const FString OutputFilename = FString::Printf(TEXT("%sTelemetry/NTBandwidth-%s.csv"), *FPaths::GameSavedDir(), *FDateTime::Now().ToString());
+	if (FFileHelper::SaveStringToFile(Output, *OutputFilename))
+	{
+		UE_LOG(LogNTGameMovement, Log, TEXT("Movement bandwidth written to %s"), *OutputFilename);
+	}
+	else
+	{
+		UE_LOG(LogNTGameMovement, Error, TEXT("Unable to write movement bandwidth to %s"), *OutputFilename);
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs NTDumpBandwidthCommand(
+	TEXT("NT.DumpBandwidth"),
+	TEXT("Export per-connection movement RPC bandwidth to CSV. NT.DumpBandwidth [reset]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&DumpNTBandwidth));
@@ -6,17 +6,23 @@
 // Movement
 #include "NTGame_MovementComponent.h"
 
+FName ANTGame_Pawn::RootMeshName(TEXT("RootMesh"));
+
 ANTGame_Pawn::ANTGame_Pawn(const FObjectInitializer& OI) : Super(OI)
 {
-	RootMesh = OI.CreateDefaultSubobject<USkeletalMeshComponent>(this, TEXT("RootMesh"));
+	RootMesh = OI.CreateDefaultSubobject<UPrimitiveComponent, USkeletalMeshComponent>(this, RootMeshName);
 	RootMesh->SetCollisionObjectType(ECollisionChannel::ECC_Vehicle);
 	RootMesh->SetCollisionProfileName(TEXT("Vehicle"));
-	RootMesh->MeshComponentUpdateFlag = EMeshComponentUpdateFlag::OnlyTickPoseWhenRendered;
 	RootMesh->SetSimulatePhysics(true);
 	RootMesh->SetLinearDamping(0.f);
 	RootMesh->SetAngularDamping(0.f);
 	RootComponent = RootMesh;
 
+	if (USkeletalMeshComponent* SkeletalRoot = Cast<USkeletalMeshComponent>(RootMesh))
+	{
+		SkeletalRoot->MeshComponentUpdateFlag = EMeshComponentUpdateFlag::OnlyTickPoseWhenRendered;
+	}
+
 	PhysicsMovement = OI.CreateDefaultSubobject<UNTGame_MovementComponent>(this, TEXT("PhysicsMovement"));
 	PhysicsMovement->SetUpdatedComponent(RootMesh);
 
@@ -34,18 +40,67 @@ ANTGame_Pawn::ANTGame_Pawn(const FObjectInitializer& OI) : Super(OI)
 	bAlwaysRelevant = true;
 	bReplicateMovement = true;
 
+	// Pooling
+	bIsPooled = false;
+
+	// Debug / Server
+	bDrawDebugRoles = true;
+	bLeanDedicatedServer = true;
+
 	// Movement Replication
 
 }
 
+void ANTGame_Pawn::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Components enable their ticks in BeginPlay, so this has to come after it
+	if (IsLeanServer())
+	{
+		// Nobody looks through the camera, so the arm's collision probe is wasted
+		CameraSpringArm->bDoCollisionTest = false;
+		CameraSpringArm->SetComponentTickEnabled(ShouldTickCameraSpringArm());
+		ViewCamera->SetComponentTickEnabled(false);
+
+		// Bounds from the mesh asset, rather than recalculated from the physics bodies on every move
+		if (USkeletalMeshComponent* SkeletalRoot = GetRootMesh())
+		{
+			SkeletalRoot->bComponentUseFixedSkelBounds = true;
+		}
+	}
+
+	// The game mode pools pawns before play begins, and BeginPlay turns their ticks back on
+	if (bIsPooled)
+	{
+		ApplyPooledState();
+	}
+}
+
 void ANTGame_Pawn::Tick(float DeltaSeconds)
 {
 	Super::Tick(DeltaSeconds);
 
+#if ENABLE_DRAW_DEBUG
+	if (!bDrawDebugRoles || GetNetMode() == NM_DedicatedServer) { return; }
+
 	const FString RoleString = Role == ROLE_Authority ? TEXT("AUTHORITY") : Role == ROLE_SimulatedProxy ? TEXT("SIMULATED") : Role == ROLE_AutonomousProxy ? TEXT("AUTONOMOUS") : TEXT("NONE");
 	const FString RemoteRoleString = GetRemoteRole() == ROLE_Authority ? TEXT("AUTHORITY") : GetRemoteRole() == ROLE_SimulatedProxy ? TEXT("SIMULATED") : GetRemoteRole() == ROLE_AutonomousProxy ? TEXT("AUTONOMOUS") : TEXT("NONE");
 	DrawDebugString(GetWorld(), GetActorLocation() + FVector(0.f, 0.f, 128.f), TEXT("Role:") + RoleString, nullptr, FColor::Red, DeltaSeconds + 0.005f, true);
 	DrawDebugString(GetWorld(), GetActorLocation() + FVector(0.f, 0.f, 100.f), TEXT("Remote:") + RemoteRoleString, nullptr, FColor::Red, DeltaSeconds + 0.005f, true);
+#endif
+}
+
+bool ANTGame_Pawn::IsLeanServer() const
+{
+	return bLeanDedicatedServer && GetNetMode() == NM_DedicatedServer;
+}
+
+bool ANTGame_Pawn::ShouldTickCameraSpringArm() const
+{
+	// Movement input is relative to the camera's rotation. An arm that can't turn only moves the camera, which a server doesn't need.
+	const bool bFixedRotation = !CameraSpringArm->bUsePawnControlRotation && !CameraSpringArm->bEnableCameraRotationLag;
+	return !(IsLeanServer() && bFixedRotation);
 }
 
 /////////////////
@@ -92,6 +147,7 @@ void ANTGame_Pawn::GetLifetimeReplicatedProps(TArray<class FLifetimeProperty> &
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
 	DOREPLIFETIME_CHANGE_CONDITION(ANTGame_Pawn, ReplicatedMovement, COND_SimulatedOrPhysicsNoReplay);
+	DOREPLIFETIME(ANTGame_Pawn, bIsPooled);
 }
 
 void ANTGame_Pawn::PawnClientRestart()
@@ -148,4 +204,64 @@ void ANTGame_Pawn::PostNetReceiveVelocity(const FVector& NewVelocity)
 		GetPhysicsMovement()->Velocity = NewVelocity;
 		GetPhysicsMovement()->UpdatedPrimitive->SetPhysicsLinearVelocity(NewVelocity, false);
 	}
+}
+
+///////////////////
+///// Pooling /////
+///////////////////
+
+void ANTGame_Pawn::DeactivateToPool()
+{
+	bIsPooled = true;
+	ApplyPooledState();
+
+	SetActorHiddenInGame(true);
+
+	// Clients keep their channel open, but nothing is sent while it waits
+	ForceNetUpdate();
+	SetNetDormancy(DORM_DormantAll);
+}
+
+void ANTGame_Pawn::ActivateFromPool(const FVector& InLocation, const FRotator& InRotation)
+{
+	bIsPooled = false;
+
+	SetNetDormancy(DORM_Awake);
+	SetActorLocationAndRotation(InLocation, InRotation, false, nullptr, ETeleportType::TeleportPhysics);
+
+	SetActorHiddenInGame(false);
+	ApplyPooledState();
+
+	ForceNetUpdate();
+}
+
+void ANTGame_Pawn::OnRep_IsPooled()
+{
+	ApplyPooledState();
+}
+
+void ANTGame_Pawn::ApplyPooledState()
+{
+	// Saved moves, timestamps and correction ids belonged to the last owner
+	PhysicsMovement->ResetMovementState();
+
+	SetActorEnableCollision(!bIsPooled);
+	SetActorTickEnabled(!bIsPooled);
+	CameraSpringArm->SetComponentTickEnabled(!bIsPooled && ShouldTickCameraSpringArm());
+
+	// Bodies are kept, just made kinematic until the pawn is used again
+	RootMesh->SetPhysicsLinearVelocity(FVector::ZeroVector);
+	RootMesh->SetPhysicsAngularVelocity(FVector::ZeroVector);
+
+	if (bIsPooled)
+	{
+		PhysicsMovement->Deactivate();
+		RootMesh->SetSimulatePhysics(false);
+	}
+	else
+	{
+		RootMesh->SetSimulatePhysics(true);
+		RootMesh->WakeAllRigidBodies();
+		PhysicsMovement->Activate(true);
+	}
 }
\ No newline at end of file
@@ -157,11 +157,8 @@ void ANTGame_PlayerController::Server_RequestPawnChange_Implementation(const uin
 	ANTGame_GameMode* WorldGM = Cast<ANTGame_GameMode>(GetWorld()->GetAuthGameMode());
 	ASSERTV(WorldGM != nullptr, TEXT("Invalid Game Mode"));
 
-	if (GetPawn())
-	{
-		// Will unpossess and properly detach from pawn
-		GetPawn()->Destroy();
-	}
+	// Keeps the old pawn pooled for the next player that wants it
+	WorldGM->ReleasePawn(GetPawn());
 	WorldGM->RestartPlayer(this);
 }
 
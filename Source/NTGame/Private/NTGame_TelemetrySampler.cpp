@@ -0,0 +1,89 @@
+// Copyright (C) James Baxter 2017. All Rights Reserved.
+
+#include "NTGame.h"
+#include "NTGame_TelemetrySampler.h"
+#include "NTGame_MovementComponent.h"
+
+/////////////////////////////
+///// Telemetry Channel /////
+/////////////////////////////
+
+float FNTGame_TelemetryChannel::GetMax() const
+{
+	float Max = 0.f;
+	for (int32 Idx = 0; Idx < Count; Idx++)
+	{
+		Max = FMath::Max(Max, GetSample(Idx));
+	}
+
+	return Max;
+}
+
+/////////////////////////////
+///// Telemetry Sampler /////
+/////////////////////////////
+
+FNTGame_TelemetrySampler::FNTGame_TelemetrySampler()
+	: SampleInterval(0.1f)
+	, TimeSinceSample(0.f)
+	, LastMovementCycles(0)
+	, LastFrameCounter(0)
+	, LastNumCorrections(0)
+{}
+
+const TCHAR* FNTGame_TelemetrySampler::GetChannelName(const ENTGame_TelemetryChannel InChannel)
+{
+	switch (InChannel)
+	{
+		case ENTGame_TelemetryChannel::RTT:				return TEXT("RTT");
+		case ENTGame_TelemetryChannel::ReplayLength:	return TEXT("Replay");
+		case ENTGame_TelemetryChannel::CorrectionRate:	return TEXT("Corrections");
+		case ENTGame_TelemetryChannel::BytesPerSecond:	return TEXT("Bandwidth");
+		case ENTGame_TelemetryChannel::MovementMS:		return TEXT("Movement");
+		case ENTGame_TelemetryChannel::Speed:			return TEXT("Speed");
+		default:										return TEXT("Unknown");
+	}
+}
+
+bool FNTGame_TelemetrySampler::Tick(const float InDeltaTime, const UNTGame_MovementComponent* InMoveComp, const UNetConnection* InConnection)
+{
+	TimeSinceSample += InDeltaTime;
+	if (TimeSinceSample < SampleInterval || InMoveComp == nullptr) { return false; }
+
+	TakeSample(TimeSinceSample, InMoveComp, InConnection);
+	TimeSinceSample = 0.f;
+	return true;
+}
+
+void FNTGame_TelemetrySampler::TakeSample(const float InElapsed, const UNTGame_MovementComponent* InMoveComp, const UNetConnection* InConnection)
+{
+	// Client Data only exists for locally predicted pawns, don't create it here
+	const FNetworkPredictionData_Client_Physics* ClientData = InMoveComp->HasPredictionData_Client() ? InMoveComp->GetPredictionData_Client_Physics() : nullptr;
+
+	float RTT = 0.f;
+	float ReplayLength = 0.f;
+	float CorrectionRate = 0.f;
+	if (ClientData)
+	{
+		RTT = ClientData->SmoothedRTT * 1000.f;
+		ReplayLength = (float)ClientData->SavedMoves.Num();
+		CorrectionRate = (float)(ClientData->NumCorrections - LastNumCorrections) / InElapsed;
+		LastNumCorrections = ClientData->NumCorrections;
+	}
+
+	const float BytesPerSecond = InConnection ? (float)(InConnection->InBytesPerSecond + InConnection->OutBytesPerSecond) : 0.f;
+
+	// Average movement cost per frame since the last sample
+	const uint64 MovementCycles = InMoveComp->GetMovementCycles();
+	const uint64 NumFrames = FMath::Max<uint64>(GFrameCounter - LastFrameCounter, 1);
+	const float MovementMS = (LastFrameCounter > 0) ? (float)((MovementCycles - LastMovementCycles) * FPlatformTime::GetSecondsPerCycle() * 1000.0 / NumFrames) : 0.f;
+	LastMovementCycles = MovementCycles;
+	LastFrameCounter = GFrameCounter;
+
+	Channels[(uint8)ENTGame_TelemetryChannel::RTT].Push(RTT);
+	Channels[(uint8)ENTGame_TelemetryChannel::ReplayLength].Push(ReplayLength);
+	Channels[(uint8)ENTGame_TelemetryChannel::CorrectionRate].Push(CorrectionRate);
+	Channels[(uint8)ENTGame_TelemetryChannel::BytesPerSecond].Push(BytesPerSecond);
+	Channels[(uint8)ENTGame_TelemetryChannel::MovementMS].Push(MovementMS);
+	Channels[(uint8)ENTGame_TelemetryChannel::Speed].Push(InMoveComp->Velocity.Size());
+}
@@ -22,10 +22,16 @@ bool UNTGame_MovementComponent::VerifyClientTimeStamp(const float TimeStamp, FNe
 			UE_LOG(LogNTGameMovement, Log, TEXT("TimeStamp reset detected. CurrentTimeStamp: %f, new TimeStamp: %f"), ServerData.CurrentClientTimeStamp, TimeStamp);
 			OnClientTimeStampResetDetected();
 			ServerData.CurrentClientTimeStamp = 0.f;
+			ServerData.FutureClientInputs.Reset();
+
+			// The lead was measured against the old timeline
+			ServerData.ClientTimeLead = 0.f;
+			ServerData.LastMoveArrivalTime = 0.0;
 		}
 		else
 		{
 			UE_LOG(LogNTGameMovement, VeryVerbose, TEXT("TimeStamp %f Accepted! CurrentTimeStamp: %f"), TimeStamp, ServerData.CurrentClientTimeStamp);
+			ProcessClientTimeStampForTimeDilation(TimeStamp, ServerData);
 			ProcessClientTimeStampForTimeDiscrepancy(TimeStamp, ServerData);
 		}
 		return true;
@@ -249,6 +255,49 @@ void UNTGame_MovementComponent::ProcessClientTimeStampForTimeDiscrepancy(float C
 	}
 }
 
+/////////////////////////
+///// Time Dilation /////
+/////////////////////////
+
+// The server applies moves as they arrive, so the 'buffer' is how far client time runs ahead of server time.
+// We keep that lead at a multiple of the measured jitter, so late packets don't starve the server of input.
+void UNTGame_MovementComponent::ProcessClientTimeStampForTimeDilation(float ClientTimeStamp, FNetworkPredictionData_Server_Physics& ServerData)
+{
+	if (!bEnableTimeDilation) { return; }
+
+	const bool bServerMoveHasOccurred = ServerData.ServerTimeStampLastServerMove != 0.f;
+	if (!bServerMoveHasOccurred) { return; }
+
+	const float WorldTimeSeconds = GetWorld()->GetTimeSeconds();
+	const float ServerDelta = (WorldTimeSeconds - ServerData.ServerTimeStampLastServerMove);
+	const float ClientDelta = ClientTimeStamp - ServerData.CurrentClientTimeStamp;
+	const float ClientError = ClientDelta - ServerDelta;
+
+	// Lead is against the time we simulate
+	ServerData.ClientTimeLead += ClientError;
+
+	// Jitter is against when the packet actually arrived, server time only moves in whole ticks
+	const UNetConnection* ClientConnection = GetOwner()->GetNetConnection();
+	const double ArrivalTime = ClientConnection ? ClientConnection->LastReceiveRealtime : FPlatformTime::Seconds();
+	if (ServerData.LastMoveArrivalTime > 0.0)
+	{
+		const float ArrivalError = ClientDelta - (float)(ArrivalTime - ServerData.LastMoveArrivalTime);
+		ServerData.ClientTimeJitter = FMath::Lerp(ServerData.ClientTimeJitter, FMath::Abs(ArrivalError), 0.1f);
+	}
+	ServerData.LastMoveArrivalTime = ArrivalTime;
+
+	if ((WorldTimeSeconds - ServerData.LastTimeDilationUpdateTime) < TimeDilationUpdateInterval) { return; }
+	ServerData.LastTimeDilationUpdateTime = WorldTimeSeconds;
+
+	const float TargetLead = FMath::Min(ServerData.ClientTimeJitter * TimeDilationJitterMultiplier, FNetworkPredictionData_Client_Physics::MaxMoveDeltaTime);
+	const float LeadError = ServerData.ClientTimeLead - TargetLead;
+
+	BandwidthStats.RecordMoveLead();
+	if (!ServerHasClientConnection()) { return; }
+
+	ClientUpdateMoveLead((int8)FMath::Clamp(FMath::RoundToInt(LeadError * 1000.f), -127, 127));
+}
+
 void UNTGame_MovementComponent::OnTimeDiscrepancyDetected(float CurrentTimeDiscrepancy, float LifetimeRawTimeDiscrepancy, float Lifetime, const float CurrentMoveError)
 {
 	// Log Issue
@@ -0,0 +1,181 @@
+// Copyright (C) James Baxter 2017. All Rights Reserved.
+
+#include "NTGame.h"
+#include "NTGame_TraceReplayCommandlet.h"
+
+#include "NTGame_MoveTrace.h"
+#include "NTGame_MovementComponent.h"
+#include "NTGame_Pawn.h"
+
+UNTGame_TraceReplayCommandlet::UNTGame_TraceReplayCommandlet(const FObjectInitializer& OI)
+	: Super(OI)
+{
+	IsClient = false;
+	IsServer = true;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UNTGame_TraceReplayCommandlet::Main(const FString& Params)
+{
+	FString TraceFilename;
+	if (!FParse::Value(*Params, TEXT("Trace="), TraceFilename))
+	{
+		UE_LOG(LogNTGameMovement, Error, TEXT("Usage: -run=NTGame_TraceReplay -Trace=<File.nttrace> [-Tolerance=<cm>]"));
+		return 1;
+	}
+
+	float Tolerance = 1.f;
+	FParse::Value(*Params, TEXT("Tolerance="), Tolerance);
+
+	FNTGame_MoveTrace Trace;
+	if (!Trace.Load(TraceFilename))
+	{
+		return 1;
+	}
+
+	UE_LOG(LogNTGameMovement, Display, TEXT("Loaded trace %s: %d records, map %s, pawn %s"), *TraceFilename, Trace.Records.Num(), *Trace.Header.MapName, *Trace.Header.PawnClassPath);
+
+	ReportClientDivergence(Trace, Tolerance);
+
+	UWorld* TraceWorld = LoadTraceWorld(Trace.Header.MapName);
+	if (TraceWorld == nullptr)
+	{
+		return 1;
+	}
+
+	const bool bReplayMatched = ReplayTrace(TraceWorld, Trace, Tolerance);
+
+	GEngine->DestroyWorldContext(TraceWorld);
+	TraceWorld->DestroyWorld(false);
+	TraceWorld->RemoveFromRoot();
+
+	return bReplayMatched ? 0 : 2;
+}
+
+UWorld* UNTGame_TraceReplayCommandlet::LoadTraceWorld(const FString& InMapName) const
+{
+	UPackage* MapPackage = LoadPackage(nullptr, *InMapName, LOAD_None);
+	UWorld* World = MapPackage ? UWorld::FindWorldInPackage(MapPackage) : nullptr;
+	if (World == nullptr)
+	{
+		UE_LOG(LogNTGameMovement, Error, TEXT("Unable to load trace map %s"), *InMapName);
+		return nullptr;
+	}
+
+	World->WorldType = EWorldType::Game;
+	World->AddToRoot();
+
+	if (!World->bIsWorldInitialized)
+	{
+		World->InitWorld(UWorld::InitializationValues()
+			.AllowAudioPlayback(false)
+			.RequiresHitProxies(false)
+			.CreatePhysicsScene(true)
+			.ShouldSimulatePhysics(true)
+			.CreateNavigation(false)
+			.CreateAISystem(false));
+	}
+
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	World->InitializeActorsForPlay(FURL());
+	return World;
+}
+
+void UNTGame_TraceReplayCommandlet::ReportClientDivergence(const FNTGame_MoveTrace& InTrace, const float InTolerance) const
+{
+	// Compare each client move with the server step that followed it
+	const FNTGame_MoveTraceRecord* LastClientMove = nullptr;
+	int32 NumDiverged = 0;
+	float MaxError = 0.f;
+
+	for (int32 Idx = 0; Idx < InTrace.Records.Num(); Idx++)
+	{
+		const FNTGame_MoveTraceRecord& Record = InTrace.Records[Idx];
+		if (Record.Type == ENTGame_TraceRecord::ClientMove)
+		{
+			LastClientMove = &Record;
+			continue;
+		}
+
+		if (LastClientMove == nullptr) { continue; }
+
+		const float LocError = FVector::Dist(LastClientMove->MoveData.Location, Record.MoveData.Location);
+		if (LocError > InTolerance)
+		{
+			if (NumDiverged == 0)
+			{
+				UE_LOG(LogNTGameMovement, Display, TEXT("Client first diverged from server at record %d (TimeStamp %f): Location %f, Velocity %f, Angular Velocity %f"),
+					Idx, LastClientMove->TimeStamp, LocError,
+					FVector::Dist(LastClientMove->MoveData.LinearVelocity, Record.MoveData.LinearVelocity),
+					FVector::Dist(LastClientMove->MoveData.AngularVelocity, Record.MoveData.AngularVelocity));
+			}
+
+			NumDiverged++;
+		}
+
+		MaxError = FMath::Max(MaxError, LocError);
+		LastClientMove = nullptr;
+	}
+
+	UE_LOG(LogNTGameMovement, Display, TEXT("Client diverged from server on %d moves, max location error %f"), NumDiverged, MaxError);
+}
+
+bool UNTGame_TraceReplayCommandlet::ReplayTrace(UWorld* InWorld, const FNTGame_MoveTrace& InTrace, const float InTolerance) const
+{
+	UClass* PawnClass = LoadObject<UClass>(nullptr, *InTrace.Header.PawnClassPath);
+	if (PawnClass == nullptr || !PawnClass->IsChildOf(ANTGame_Pawn::StaticClass()))
+	{
+		UE_LOG(LogNTGameMovement, Error, TEXT("Invalid trace pawn class %s"), *InTrace.Header.PawnClassPath);
+		return false;
+	}
+
+	FActorSpawnParameters SpawnInfo;
+	SpawnInfo.ObjectFlags |= RF_Transient;
+	SpawnInfo.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	const FRepPawnMoveData& Initial = InTrace.Header.InitialState;
+	ANTGame_Pawn* TracePawn = InWorld->SpawnActor<ANTGame_Pawn>(PawnClass, Initial.Location, Initial.Rotation.Rotator(), SpawnInfo);
+	ASSERTV_WR(TracePawn != nullptr, false, TEXT("Unable To Spawn Trace Pawn"));
+
+	UNTGame_MovementComponent* MoveComp = TracePawn->GetPhysicsMovement();
+	ASSERTV_WR(MoveComp != nullptr && MoveComp->UpdatedPrimitive != nullptr, false, TEXT("Invalid Trace Pawn Movement"));
+
+	MoveComp->SetCurrentMoveData(Initial);
+	MoveComp->SyncComponentToBody();
+
+	// Re-run every move and step in order, and compare against what the server recorded
+	for (int32 Idx = 0; Idx < InTrace.Records.Num(); Idx++)
+	{
+		const FNTGame_MoveTraceRecord& Record = InTrace.Records[Idx];
+		if (Record.Type == ENTGame_TraceRecord::ClientMove)
+		{
+			MoveComp->PerformMovement(Record.DeltaTime, Record.Input);
+			continue;
+		}
+
+		MoveComp->SimulatePhysicsScene(Record.DeltaTime, UNTGame_MovementComponent::ComputeNumSubsteps(Record.DeltaTime));
+		MoveComp->SyncComponentToBody();
+
+		const FRepPawnMoveData Replayed = MoveComp->GetCurrentMoveData();
+		const float LocError = FVector::Dist(Replayed.Location, Record.MoveData.Location);
+		if (LocError > InTolerance)
+		{
+			UE_LOG(LogNTGameMovement, Display, TEXT("Re-simulation first diverged from server at record %d: Location %f, Rotation %f deg, Velocity %f, Angular Velocity %f"),
+				Idx, LocError,
+				FMath::RadiansToDegrees(Replayed.Rotation.AngularDistance(Record.MoveData.Rotation)),
+				FVector::Dist(Replayed.LinearVelocity, Record.MoveData.LinearVelocity),
+				FVector::Dist(Replayed.AngularVelocity, Record.MoveData.AngularVelocity));
+
+			TracePawn->Destroy();
+			return false;
+		}
+	}
+
+	UE_LOG(LogNTGameMovement, Display, TEXT("Re-simulation matched the server within %f for all %d records"), InTolerance, InTrace.Records.Num());
+
+	TracePawn->Destroy();
+	return true;
+}